@@ -9,6 +9,7 @@
 #include "Cool/Log/message_console.hpp"
 #include "ImGuiNotify/ImGuiNotify.hpp"
 #include "LauncherSettings.hpp"
+#include "Version/LaunchTimelines.hpp"
 #include "Version/VersionManager.hpp"
 #include "Version/VersionRef.hpp"
 #include "imgui.h"
@@ -28,6 +29,10 @@ void App::init()
 
 void App::update()
 {
+    version_manager().update();
+    if (_project_manager.has_finished_loading_projects() && version_manager().needs_to_check_disk_quota()) // Wait for all the projects to be loaded, otherwise we might uninstall a version that one of them needs
+        version_manager().check_disk_quota(_project_manager.versions_used_by_projects());
+
     auto const& io = ImGui::GetIO();
     if (inputs_are_allowed() && !io.WantTextInput)
     {
@@ -109,6 +114,7 @@ void App::imgui_windows()
 {
     Cool::message_console().imgui_window();
     Cool::debug_options_windows(nullptr, _window);
+    Launcher::DebugOptions::launch_timeline_window([]() { launch_timelines().imgui(); });
     { // Versions
         ImGui::Begin("Versions");
         version_manager().imgui_manage_versions();
@@ -195,7 +201,8 @@ void App::open_external_project()
 
 void App::open_new_project()
 {
-    version_manager().install_ifn_and_launch(_version_to_use_for_new_project, FolderToCreateNewProject{_projects_folder});
+    auto const launch_id = launch_timelines().start("Creating a new project");
+    version_manager().install_ifn_and_launch(_version_to_use_for_new_project, FolderToCreateNewProject{_projects_folder}, launch_id);
 }
 
 void App::launch(Project const& project)
@@ -210,10 +217,13 @@ void App::launch(Project const& project)
         });
         return;
     }
-    version_manager().install_ifn_and_launch(*version, FileToOpen{project.file_path()});
+    auto const launch_id = launch_timelines().start(fmt::format("Opening \"{}\" with {}", project.name(), version->as_string()));
+    version_manager().install_ifn_and_launch(*version, FileToOpen{project.file_path()}, launch_id);
 }
 
 void App::launch(std::filesystem::path const& project_file_path)
 {
-    launch(Project{project_file_path});
+    auto const project = Project{project_file_path};
+    project.set_file_metadata(probe_project_file(project_file_path)); // The user is waiting for this file to open, so we read its version right away instead of in the background
+    launch(project);
 }
\ No newline at end of file
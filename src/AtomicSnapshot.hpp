@@ -0,0 +1,36 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// A value that is read very often, from several threads, and only replaced once in a while.
+/// Readers get an immutable snapshot without taking any lock (just an atomic load). The writer publishes a new value, which replaces the old one atomically.
+/// Old snapshots are never destroyed, so that readers can keep using the one they got (e.g. for a whole frame) even if a new one gets published in the meantime.
+/// This is only meant for values that are replaced a handful of times per run of the app.
+template<typename T>
+class AtomicSnapshot {
+public:
+    explicit AtomicSnapshot(T initial_value = {})
+    {
+        publish(std::move(initial_value));
+    }
+
+    auto get() const -> T const& { return *_current.load(std::memory_order_acquire); }
+
+    void publish(T value)
+    {
+        auto        snapshot = std::make_unique<T const>(std::move(value));
+        auto const* pointer  = snapshot.get();
+        {
+            std::unique_lock lock{_all_snapshots_mutex}; // Only protects the writers from each other
+            _all_snapshots.push_back(std::move(snapshot));
+        }
+        _current.store(pointer, std::memory_order_release);
+    }
+
+private:
+    std::atomic<T const*>                 _current{nullptr};
+    std::vector<std::unique_ptr<T const>> _all_snapshots{};
+    std::mutex                            _all_snapshots_mutex{};
+};
@@ -25,6 +25,12 @@ def all_debug_options():
             name_in_ui="Log when uninstalling versions automatically",
             available_in_release=True,
         ),
+        DebugOption(
+            name_in_code="launch_timeline_window",
+            name_in_ui="Launch timeline",
+            available_in_release=True,
+            kind=Kind.WINDOW,
+        ),
     ]
 
 
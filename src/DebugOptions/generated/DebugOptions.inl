@@ -21,12 +21,23 @@ namespace Launcher {
 class DebugOptions {
 public:
     [[nodiscard]] static auto log_when_uninstalling_versions_automatically() -> bool& { return instance().log_when_uninstalling_versions_automatically; }
+    [[nodiscard]] static auto launch_timeline_window() -> bool& { return instance().launch_timeline_window; }
+    static void launch_timeline_window(std::function<void()> callback)
+    {
+        if (instance().launch_timeline_window)
+        {
+            ImGui::Begin(Cool::icon_fmt("Launch timeline", ICOMOON_WRENCH).c_str(), &instance().launch_timeline_window, ImGuiWindowFlags_NoFocusOnAppearing);
+            callback();
+            ImGui::End();
+        }
+    }
 
     static void save() { instance()._serializer.save(); }
 
 private:
     struct Instance {
         bool log_when_uninstalling_versions_automatically{false};
+        bool launch_timeline_window{false};
 
         // Must be declared last, after all the variables it serializes, so that the values it loads overwrite the default values, and not the other way around
         Cool::JsonAutoSerializer _serializer{
@@ -36,16 +47,20 @@ private:
 
 #if DEBUG
                 Cool::json_get(json, "Log when uninstalling versions automatically", log_when_uninstalling_versions_automatically);
+                Cool::json_get(json, "Launch timeline", launch_timeline_window);
 #else
                 Cool::json_get(json, "Log when uninstalling versions automatically", log_when_uninstalling_versions_automatically);
+                Cool::json_get(json, "Launch timeline", launch_timeline_window);
 #endif
             },
             [&](nlohmann::json& json) {
 
 #if DEBUG
                 Cool::json_set(json, "Log when uninstalling versions automatically", log_when_uninstalling_versions_automatically);
+                Cool::json_set(json, "Launch timeline", launch_timeline_window);
 #else
                 Cool::json_set(json, "Log when uninstalling versions automatically", log_when_uninstalling_versions_automatically);
+                Cool::json_set(json, "Launch timeline", launch_timeline_window);
 #endif
             },
             false /*use_shared_user_data*/,
@@ -65,6 +80,7 @@ private:
     static void reset_all()
     {
         instance().log_when_uninstalling_versions_automatically = false;
+        instance().launch_timeline_window                       = false;
         save();
     }
 
@@ -78,6 +94,12 @@ private:
             if (Cool::ImGuiExtras::toggle("Log when uninstalling versions automatically", &instance().log_when_uninstalling_versions_automatically))
                 save();
         }
+
+        if (wafl::similarity_match({filter, "Launch timeline"}) >= wafl::Matches::Strongly)
+        {
+            if (Cool::ImGuiExtras::toggle("Launch timeline", &instance().launch_timeline_window))
+                save();
+        }
     }
 
     static void toggle_first_option(std::string_view filter)
@@ -88,6 +110,13 @@ private:
             save();
             throw 0.f; // To understand why we need to throw, see `toggle_first_option()` in <Cool/DebugOptions/DebugOptionsManager.h>
         }
+
+        if (wafl::similarity_match({filter, "Launch timeline"}) >= wafl::Matches::Strongly)
+        {
+            instance().launch_timeline_window = !instance().launch_timeline_window;
+            save();
+            throw 0.f; // To understand why we need to throw, see `toggle_first_option()` in <Cool/DebugOptions/DebugOptionsManager.h>
+        }
     }
 };
 
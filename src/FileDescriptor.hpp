@@ -0,0 +1,28 @@
+#pragma once
+#if defined(__linux__) || defined(__APPLE__)
+#include <unistd.h>
+
+/// Closes the file descriptor (of a file, a socket, etc.) when it goes out of scope
+class FileDescriptor {
+public:
+    explicit FileDescriptor(int fd)
+        : _fd{fd}
+    {}
+    ~FileDescriptor()
+    {
+        if (_fd != -1)
+            close(_fd);
+    }
+    FileDescriptor(FileDescriptor const&)                    = delete;
+    auto operator=(FileDescriptor const&) -> FileDescriptor& = delete;
+    FileDescriptor(FileDescriptor&&)                         = delete;
+    auto operator=(FileDescriptor&&) -> FileDescriptor&      = delete;
+
+    /// -1 if the function that created the file descriptor failed
+    auto get() const -> int { return _fd; }
+
+private:
+    int _fd;
+};
+
+#endif
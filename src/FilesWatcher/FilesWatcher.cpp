@@ -0,0 +1,12 @@
+#include "FilesWatcher.hpp"
+#include "FilesWatcher_Inotify.hpp"
+#include "FilesWatcher_Polling.hpp"
+
+auto make_files_watcher() -> std::unique_ptr<FilesWatcher>
+{
+#if defined(__linux__)
+    return std::make_unique<FilesWatcher_Inotify>(); // Falls back to polling on its own if inotify is not available
+#else
+    return std::make_unique<FilesWatcher_Polling>(); // TODO(Launcher) Use ReadDirectoryChangesW on Windows and FSEvents on MacOS
+#endif
+}
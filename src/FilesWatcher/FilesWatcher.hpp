@@ -0,0 +1,32 @@
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+struct FilesChanges {
+    std::vector<std::filesystem::path> paths{};                            // The watched paths that have been created, modified, deleted or moved
+    bool                               everything_might_have_changed{false}; // When the backend has lost track of some events (e.g. its queue overflowed)
+};
+
+/// Watches files in the background and reports the ones that changed, so that we don't have to query the file system every frame.
+/// The watched paths don't need to exist yet, we will be notified when they get created.
+class FilesWatcher {
+public:
+    FilesWatcher()                                       = default;
+    virtual ~FilesWatcher()                              = default;
+    FilesWatcher(FilesWatcher const&)                    = delete;
+    auto operator=(FilesWatcher const&) -> FilesWatcher& = delete;
+    FilesWatcher(FilesWatcher&&)                         = delete;
+    auto operator=(FilesWatcher&&) -> FilesWatcher&      = delete;
+
+    virtual void watch(std::filesystem::path const&)   = 0;
+    virtual void unwatch(std::filesystem::path const&) = 0;
+    /// Reports the folder itself when something gets created, deleted or renamed directly inside it (but not when an existing file gets modified)
+    virtual void watch_folder_content(std::filesystem::path const& folder)   = 0;
+    virtual void unwatch_folder_content(std::filesystem::path const& folder) = 0;
+    /// Returns the changes that happened since the last call. This doesn't make any system call, so it is fine to call it every frame
+    virtual auto pop_changes() -> FilesChanges = 0;
+};
+
+/// Uses the most efficient backend available on the current platform
+auto make_files_watcher() -> std::unique_ptr<FilesWatcher>;
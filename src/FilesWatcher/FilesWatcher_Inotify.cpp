@@ -0,0 +1,281 @@
+#if defined(__linux__)
+#include "FilesWatcher_Inotify.hpp"
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <array>
+#include "Cool/Log/Log.hpp"
+
+static constexpr uint32_t events_mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+FilesWatcher_Inotify::FilesWatcher_Inotify()
+    : _inotify_fd{inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}
+{
+    if (_inotify_fd == -1 || pipe2(_stop_pipe, O_CLOEXEC) == -1) // NOLINT(*array-to-pointer-decay)
+    {
+        Cool::Log::internal_warning("Files watcher", fmt::format("Failed to initialize inotify ({}), falling back to polling", strerror(errno)));
+        if (_inotify_fd != -1)
+            close(_inotify_fd);
+        _inotify_fd = -1;
+        return;
+    }
+
+    _thread = std::thread{[this]() {
+        auto fds = std::array<pollfd, 2>{
+            pollfd{.fd = _inotify_fd, .events = POLLIN, .revents = 0},
+            pollfd{.fd = _stop_pipe[0], .events = POLLIN, .revents = 0},
+        };
+        while (true)
+        {
+            if (poll(fds.data(), fds.size(), -1) == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+                Cool::Log::internal_warning("Files watcher", strerror(errno));
+                return;
+            }
+            if (fds[1].revents != 0)
+                return;
+            if (fds[0].revents != 0)
+                read_events();
+        }
+    }};
+}
+
+FilesWatcher_Inotify::~FilesWatcher_Inotify()
+{
+    if (_inotify_fd == -1)
+        return;
+    char const stop{0};
+    [[maybe_unused]] auto const _ = write(_stop_pipe[1], &stop, 1);
+    _thread.join();
+    close(_stop_pipe[0]);
+    close(_stop_pipe[1]);
+    close(_inotify_fd);
+}
+
+auto FilesWatcher_Inotify::add_watch_ifn(std::filesystem::path const& folder) -> WatchedFolder*
+{
+    if (auto const it = _watched_folders.find(folder); it != _watched_folders.end())
+        return &it->second;
+
+    auto const watch_descriptor = _inotify_fd == -1 ? -1 : inotify_add_watch(_inotify_fd, folder.c_str(), events_mask);
+    if (watch_descriptor == -1)
+        return nullptr;
+    // Several spellings of the same folder give the same watch descriptor, so make sure we only track it once
+    auto const [it, is_new]         = _folder_of_watch_descriptor.try_emplace(watch_descriptor, folder);
+    auto&      watched_folder       = _watched_folders[it->second];
+    watched_folder.watch_descriptor = watch_descriptor;
+    return &watched_folder;
+}
+
+void FilesWatcher_Inotify::remove_watch_if_unused(std::map<std::filesystem::path, WatchedFolder>::iterator it)
+{
+    if (!it->second.file_names.empty() || it->second.watch_content)
+        return;
+    inotify_rm_watch(_inotify_fd, it->second.watch_descriptor);
+    _folder_of_watch_descriptor.erase(it->second.watch_descriptor);
+    _watched_folders.erase(it);
+}
+
+void FilesWatcher_Inotify::watch(std::filesystem::path const& path)
+{
+    {
+        auto lock = std::unique_lock{_mutex};
+        if (auto* const watched_folder = add_watch_ifn(path.parent_path()))
+        {
+            watched_folder->file_names.insert(path.filename().string());
+            return;
+        }
+    }
+    // The folder doesn't exist (yet), or we reached the maximum number of watches (cf. /proc/sys/fs/inotify/max_user_watches)
+    _fallback.watch(path);
+}
+
+void FilesWatcher_Inotify::unwatch(std::filesystem::path const& path)
+{
+    _fallback.unwatch(path);
+
+    auto       lock = std::unique_lock{_mutex};
+    auto const it   = _watched_folders.find(path.parent_path());
+    if (it == _watched_folders.end())
+        return;
+    it->second.file_names.erase(path.filename().string());
+    remove_watch_if_unused(it);
+}
+
+void FilesWatcher_Inotify::watch_folder_content(std::filesystem::path const& folder)
+{
+    {
+        auto lock = std::unique_lock{_mutex};
+        if (auto* const watched_folder = add_watch_ifn(folder))
+        {
+            watched_folder->watch_content = true;
+            return;
+        }
+    }
+    _fallback.watch_folder_content(folder);
+}
+
+void FilesWatcher_Inotify::unwatch_folder_content(std::filesystem::path const& folder)
+{
+    _fallback.unwatch_folder_content(folder);
+
+    auto       lock = std::unique_lock{_mutex};
+    auto const it   = _watched_folders.find(folder);
+    if (it == _watched_folders.end())
+        return;
+    it->second.watch_content = false;
+    remove_watch_if_unused(it);
+}
+
+auto FilesWatcher_Inotify::pop_changes() -> FilesChanges
+{
+    auto changes = _fallback.pop_changes();
+    auto lock    = std::unique_lock{_mutex};
+    std::move(_changes.paths.begin(), _changes.paths.end(), std::back_inserter(changes.paths));
+    changes.everything_might_have_changed |= _changes.everything_might_have_changed;
+    _changes = {};
+    return changes;
+}
+
+void FilesWatcher_Inotify::read_events()
+{
+    alignas(inotify_event) auto buffer = std::array<char, 64 * 1024>{};
+
+    auto files_to_poll   = std::vector<std::filesystem::path>{};
+    auto folders_to_poll = std::vector<std::filesystem::path>{};
+    while (true)
+    {
+        auto const length = read(_inotify_fd, buffer.data(), buffer.size());
+        if (length <= 0)
+            break; // EAGAIN: we have read all the events
+
+        auto lock = std::unique_lock{_mutex};
+        for (char const* ptr = buffer.data(); ptr < buffer.data() + length;)
+        {
+            auto const& event = *reinterpret_cast<inotify_event const*>(ptr); // NOLINT(*reinterpret-cast)
+            ptr += sizeof(inotify_event) + event.len;
+
+            if (event.mask & IN_Q_OVERFLOW)
+            {
+                _changes.everything_might_have_changed = true;
+                continue;
+            }
+            auto const folder_it = _folder_of_watch_descriptor.find(event.wd);
+            if (folder_it == _folder_of_watch_descriptor.end())
+                continue;
+            auto const& folder         = folder_it->second;
+            auto&       watched_folder = _watched_folders[folder];
+            auto&       files          = watched_folder.file_names;
+
+            if (event.mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+            {
+                // The folder itself is gone, so all its files changed. Since the folder might be recreated later, keep watching them by polling
+                for (auto const& file_name : files)
+                {
+                    _changes.paths.push_back(folder / file_name);
+                    files_to_poll.push_back(folder / file_name);
+                }
+                if (watched_folder.watch_content)
+                {
+                    _changes.paths.push_back(folder);
+                    folders_to_poll.push_back(folder);
+                }
+                inotify_rm_watch(_inotify_fd, event.wd);
+                _watched_folders.erase(folder);
+                _folder_of_watch_descriptor.erase(folder_it);
+                continue;
+            }
+            if (event.len == 0)
+                continue;
+            if (watched_folder.watch_content && (event.mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)))
+                _changes.paths.push_back(folder);
+            auto const file_name = std::string{event.name}; // NOLINT(*array-to-pointer-decay)
+            if (files.contains(file_name))
+                _changes.paths.push_back(folder / file_name);
+        }
+    }
+
+    for (auto const& path : files_to_poll)
+        _fallback.watch(path);
+    for (auto const& folder : folders_to_poll)
+        _fallback.watch_folder_content(folder);
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include <fstream>
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+static auto wait_for_change(FilesWatcher& watcher, std::filesystem::path const& path) -> bool
+{
+    for (int i = 0; i < 200; ++i)
+    {
+        auto const changes = watcher.pop_changes();
+        if (std::find(changes.paths.begin(), changes.paths.end(), path) != changes.paths.end())
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    return false;
+}
+
+TEST_CASE("FilesWatcher reports the creation, modification and deletion of the watched files")
+{
+    auto const folder = TemporaryFolder{"FilesWatcher"};
+    auto const file = folder / "project.coollab";
+
+    auto inotify = FilesWatcher_Inotify{};
+    auto polling = FilesWatcher_Polling{std::chrono::milliseconds{10}};
+    for (FilesWatcher* watcher : std::array<FilesWatcher*, 2>{&inotify, &polling})
+    {
+        watcher->watch(file);
+        std::this_thread::sleep_for(std::chrono::milliseconds{50}); // Make sure the polling backend has seen the initial state
+
+        std::ofstream{file} << "19.0.0";
+        CHECK(wait_for_change(*watcher, file));
+
+        std::filesystem::remove(file);
+        CHECK(wait_for_change(*watcher, file));
+
+        std::ofstream{folder / "another file"} << "We are not watching it";
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        CHECK(watcher->pop_changes().paths.empty());
+        std::filesystem::remove(folder / "another file");
+    }
+}
+
+TEST_CASE("FilesWatcher reports the folders whose content changes")
+{
+    auto const folder = TemporaryFolder{"FilesWatcher folder content"};
+    std::ofstream{folder / "existing file"} << "a";
+
+    auto inotify = FilesWatcher_Inotify{};
+    auto polling = FilesWatcher_Polling{std::chrono::milliseconds{10}};
+    for (FilesWatcher* watcher : std::array<FilesWatcher*, 2>{&inotify, &polling})
+    {
+        watcher->watch_folder_content(folder.path());
+        std::this_thread::sleep_for(std::chrono::milliseconds{50}); // Make sure the polling backend has seen the initial state
+
+        std::ofstream{folder / "new.coollab"} << "19.0.0";
+        CHECK(wait_for_change(*watcher, folder.path()));
+
+        std::filesystem::create_directory(folder / "new folder");
+        CHECK(wait_for_change(*watcher, folder.path()));
+
+        std::filesystem::remove(folder / "new.coollab");
+        std::filesystem::remove(folder / "new folder");
+        CHECK(wait_for_change(*watcher, folder.path()));
+
+        watcher->unwatch_folder_content(folder.path());
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        std::ignore = watcher->pop_changes();
+        std::ofstream{folder / "ignored.coollab"} << "19.0.0";
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        CHECK(watcher->pop_changes().paths.empty());
+        std::filesystem::remove(folder / "ignored.coollab");
+    }
+}
+#endif
+#endif
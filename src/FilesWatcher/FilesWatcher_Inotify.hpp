@@ -0,0 +1,55 @@
+#pragma once
+#if defined(__linux__)
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include "FilesWatcher.hpp"
+#include "FilesWatcher_Polling.hpp"
+
+/// Linux backend: watches the folders that contain the watched files, and gets notified by the kernel when something changes in them
+class FilesWatcher_Inotify : public FilesWatcher {
+public:
+    FilesWatcher_Inotify();
+    ~FilesWatcher_Inotify() override;
+    FilesWatcher_Inotify(FilesWatcher_Inotify const&)                    = delete;
+    auto operator=(FilesWatcher_Inotify const&) -> FilesWatcher_Inotify& = delete;
+    FilesWatcher_Inotify(FilesWatcher_Inotify&&)                         = delete;
+    auto operator=(FilesWatcher_Inotify&&) -> FilesWatcher_Inotify&      = delete;
+
+    void watch(std::filesystem::path const&) override;
+    void unwatch(std::filesystem::path const&) override;
+    void watch_folder_content(std::filesystem::path const& folder) override;
+    void unwatch_folder_content(std::filesystem::path const& folder) override;
+    auto pop_changes() -> FilesChanges override;
+
+    /// False if we failed to initialize inotify, in which case all the files are polled
+    auto is_valid() const -> bool { return _inotify_fd != -1; }
+
+private:
+    struct WatchedFolder {
+        int                   watch_descriptor{};
+        std::set<std::string> file_names{};
+        bool                  watch_content{false}; // Cf. watch_folder_content()
+    };
+
+    void read_events();
+    /// Must be called with _mutex locked. Returns nullptr if we can't watch the folder with inotify
+    auto add_watch_ifn(std::filesystem::path const& folder) -> WatchedFolder*;
+    /// Must be called with _mutex locked
+    void remove_watch_if_unused(std::map<std::filesystem::path, WatchedFolder>::iterator);
+
+private:
+    int _inotify_fd{-1};
+    int _stop_pipe[2]{-1, -1}; // Written to in the destructor, to wake up the thread that waits for events // NOLINT(*avoid-c-arrays)
+
+    // Guarded by _mutex
+    std::map<std::filesystem::path, WatchedFolder> _watched_folders{};
+    std::map<int, std::filesystem::path>           _folder_of_watch_descriptor{};
+    FilesChanges                                   _changes{};
+    std::mutex                                     _mutex{};
+
+    FilesWatcher_Polling _fallback{}; // For the folders we can't watch (e.g. when we reach the system limit on the number of watches, or when the folder doesn't exist yet)
+    std::thread          _thread{};   // Must be declared last, so that it is started after everything else has been initialized
+};
+#endif
@@ -0,0 +1,88 @@
+#include "FilesWatcher_Polling.hpp"
+#include <algorithm>
+#include "lower_io_priority_of_current_thread.hpp"
+
+static auto last_write_time_if_exists(std::filesystem::path const& path) -> std::optional<std::filesystem::file_time_type>
+{
+    auto       error_code = std::error_code{};
+    auto const time       = std::filesystem::last_write_time(path, error_code);
+    if (error_code)
+        return std::nullopt;
+    return time;
+}
+
+FilesWatcher_Polling::FilesWatcher_Polling(std::chrono::milliseconds delay_between_checks, unsigned int max_checks_per_second)
+    : _delay_between_checks{delay_between_checks}
+    , _max_checks_per_second{std::max(max_checks_per_second, 1u)}
+    , _thread{[this]() {
+        lower_io_priority_of_current_thread();
+        auto lock = std::unique_lock{_mutex};
+        while (!_condition.wait_for(lock, _delay_between_checks, [&]() { return _wants_to_stop; }))
+        {
+            lock.unlock();
+            check_all_files();
+            lock.lock();
+        }
+    }}
+{}
+
+FilesWatcher_Polling::~FilesWatcher_Polling()
+{
+    {
+        auto lock      = std::unique_lock{_mutex};
+        _wants_to_stop = true;
+    }
+    _condition.notify_one();
+    _thread.join();
+}
+
+void FilesWatcher_Polling::watch(std::filesystem::path const& path)
+{
+    auto const time = last_write_time_if_exists(path); // Outside of the lock, this might be slow
+    auto       lock = std::unique_lock{_mutex};
+    _watched_files.insert_or_assign(path, time);
+}
+
+void FilesWatcher_Polling::unwatch(std::filesystem::path const& path)
+{
+    auto lock = std::unique_lock{_mutex};
+    _watched_files.erase(path);
+}
+
+auto FilesWatcher_Polling::pop_changes() -> FilesChanges
+{
+    auto lock = std::unique_lock{_mutex};
+    return std::exchange(_changes, FilesChanges{});
+}
+
+void FilesWatcher_Polling::check_all_files()
+{
+    auto paths = std::vector<std::filesystem::path>{};
+    {
+        auto lock = std::unique_lock{_mutex};
+        paths.reserve(_watched_files.size());
+        for (auto const& [path, _] : _watched_files)
+            paths.push_back(path);
+    }
+
+    // Query the file system without holding the lock, so that watch() and pop_changes() never wait on a slow drive
+    auto const time_per_check = std::chrono::microseconds{1'000'000 / _max_checks_per_second};
+    auto       time_of_check  = std::chrono::steady_clock::now();
+    for (auto const& path : paths)
+    {
+        {
+            auto lock = std::unique_lock{_mutex};
+            if (_condition.wait_until(lock, time_of_check, [&]() { return _wants_to_stop; }))
+                return;
+        }
+        time_of_check += time_per_check;
+
+        auto const time = last_write_time_if_exists(path);
+        auto       lock = std::unique_lock{_mutex};
+        auto const it   = _watched_files.find(path);
+        if (it == _watched_files.end() || it->second == time)
+            continue; // Unwatched in the meantime, or unchanged
+        it->second = time;
+        _changes.paths.push_back(path);
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "FilesWatcher.hpp"
+
+/// Portable backend: a background thread checks the last write time of each watched file periodically.
+/// It is throttled, because it can end up with a lot of files (e.g. when inotify reaches its limit on the number of watches): its thread has the lowest I/O priority, and it checks a limited number of files per second.
+class FilesWatcher_Polling : public FilesWatcher {
+public:
+    explicit FilesWatcher_Polling(std::chrono::milliseconds delay_between_checks = std::chrono::seconds{1}, unsigned int max_checks_per_second = 1000);
+    ~FilesWatcher_Polling() override;
+    FilesWatcher_Polling(FilesWatcher_Polling const&)                    = delete;
+    auto operator=(FilesWatcher_Polling const&) -> FilesWatcher_Polling& = delete;
+    FilesWatcher_Polling(FilesWatcher_Polling&&)                         = delete;
+    auto operator=(FilesWatcher_Polling&&) -> FilesWatcher_Polling&      = delete;
+
+    void watch(std::filesystem::path const&) override;
+    void unwatch(std::filesystem::path const&) override;
+    /// The last write time of a folder changes when something gets created, deleted or renamed inside it, so we can watch it like a file
+    void watch_folder_content(std::filesystem::path const& folder) override { watch(folder); }
+    void unwatch_folder_content(std::filesystem::path const& folder) override { unwatch(folder); }
+    auto pop_changes() -> FilesChanges override;
+
+private:
+    void check_all_files();
+
+private:
+    std::chrono::milliseconds _delay_between_checks;
+    unsigned int              _max_checks_per_second;
+    // Guarded by _mutex
+    std::map<std::filesystem::path, std::optional<std::filesystem::file_time_type>> _watched_files{}; // std::nullopt when the file doesn't exist
+    FilesChanges                                                                    _changes{};
+    bool                                                                            _wants_to_stop{false};
+    std::mutex                                                                      _mutex{};
+    std::condition_variable                                                         _condition{};
+    std::thread                                                                     _thread{}; // Must be declared last, so that it is started after everything else has been initialized
+};
@@ -1,5 +1,7 @@
 #include "LauncherSettings.hpp"
 #include "Cool/ImGui/ImGuiExtras.h"
+#include "Path.hpp"
+#include "UpgradeDecisionsGeneration.hpp"
 #include "Version/VersionManager.hpp"
 
 void LauncherSettings::imgui()
@@ -18,6 +20,83 @@ void LauncherSettings::imgui()
     b |= Cool::ImGuiExtras::toggle("Show experimental versions", &show_experimental_versions);
     Cool::ImGuiExtras::help_marker("These versions are highly unstable and should only be used if you know what you are doing");
 
+    {
+        bool quota_changed = Cool::ImGuiExtras::toggle("Limit disk space used by installed versions", &limit_disk_space_used_by_versions);
+        Cool::ImGuiExtras::help_marker("When the installed versions take more space than this, we uninstall the ones you haven't launched for the longest time. We never uninstall a version that one of your projects needs.");
+        if (limit_disk_space_used_by_versions)
+        {
+            if (ImGui::InputInt("GB", &max_disk_space_used_by_versions_in_GB))
+            {
+                max_disk_space_used_by_versions_in_GB = std::max(max_disk_space_used_by_versions_in_GB, 1);
+                quota_changed                         = true;
+            }
+        }
+        if (quota_changed)
+            version_manager().request_disk_quota_check();
+        b |= quota_changed;
+    }
+
+    {
+        bool folders_changed = Cool::ImGuiExtras::toggle("Discover projects automatically", &discover_projects_automatically);
+        Cool::ImGuiExtras::help_marker("Looks for the projects in your projects folder and in the folders below, so that the projects you have never opened through the launcher (e.g. the ones you copied from another computer) also show up in the list. This runs in the background and never slows down Coollab.");
+        if (discover_projects_automatically)
+        {
+            ImGui::TextDisabled("%s", Path::default_projects_folder().string().c_str());
+            std::optional<size_t> folder_to_remove{};
+            for (size_t i = 0; i < folders_to_discover_projects_in.size(); ++i)
+            {
+                ImGui::PushID(static_cast<int>(i));
+                if (ImGui::Button("Remove"))
+                    folder_to_remove = i;
+                ImGui::SameLine();
+                auto folder = std::filesystem::path{folders_to_discover_projects_in[i]};
+                if (Cool::ImGuiExtras::folder("", &folder))
+                {
+                    folders_to_discover_projects_in[i] = folder.string();
+                    folders_changed                    = true;
+                }
+                ImGui::PopID();
+            }
+            if (folder_to_remove.has_value())
+            {
+                folders_to_discover_projects_in.erase(folders_to_discover_projects_in.begin() + static_cast<std::ptrdiff_t>(*folder_to_remove));
+                folders_changed = true;
+            }
+            if (ImGui::Button("Add a folder"))
+                folders_to_discover_projects_in.emplace_back(); // The user then picks it with the folder widget
+        }
+        if (folders_changed)
+            _generation_of_folders_to_discover_projects_in++;
+        b |= folders_changed;
+    }
+
+#if defined(__linux__)
+    b |= Cool::ImGuiExtras::toggle("Extract the versions when installing them", &extract_appimages_at_installation);
+    Cool::ImGuiExtras::help_marker("Coollab then starts faster, and works on the computers that don't have FUSE, but each version takes about twice as much disk space. This only applies to the versions you install from now on.");
+#endif
+
     if (b)
+    {
         _serializer.save();
-}
\ No newline at end of file
+        upgrade_decisions_generation().bump();
+    }
+}
+
+auto LauncherSettings::disk_quota_for_versions_in_bytes() const -> std::optional<uintmax_t>
+{
+    if (!limit_disk_space_used_by_versions)
+        return std::nullopt;
+    return static_cast<uintmax_t>(max_disk_space_used_by_versions_in_GB) * 1'000'000'000;
+}
+auto LauncherSettings::folders_to_discover_projects_in_including_default() const -> std::vector<std::filesystem::path>
+{
+    if (!discover_projects_automatically)
+        return {};
+    auto res = std::vector<std::filesystem::path>{Path::default_projects_folder()};
+    for (auto const& folder : folders_to_discover_projects_in)
+    {
+        if (!folder.empty())
+            res.emplace_back(folder);
+    }
+    return res;
+}
@@ -3,25 +3,47 @@
 #include "Cool/Serialization/JsonAutoSerializer.hpp"
 
 struct LauncherSettings {
-    bool automatically_install_latest_version{true};
-    bool automatically_upgrade_projects_to_latest_compatible_version{true};
-    bool show_experimental_versions{false};
+    bool                     automatically_install_latest_version{true};
+    bool                     automatically_upgrade_projects_to_latest_compatible_version{true};
+    bool                     show_experimental_versions{false};
+    bool                     limit_disk_space_used_by_versions{false};
+    int                      max_disk_space_used_by_versions_in_GB{5};
+    bool                     discover_projects_automatically{false};
+    std::vector<std::string> folders_to_discover_projects_in{};        // On top of Path::default_projects_folder()
+    bool                     extract_appimages_at_installation{false}; // Only used on Linux
 
     void imgui();
+    auto disk_quota_for_versions_in_bytes() const -> std::optional<uintmax_t>;
+    /// The folders that the ProjectsCrawler walks, or nothing if the user hasn't enabled the discovery of projects
+    auto folders_to_discover_projects_in_including_default() const -> std::vector<std::filesystem::path>;
+    /// Changes every time the folders_to_discover_projects_in_including_default() might have changed, so that we don't have to compute them every frame
+    auto generation_of_folders_to_discover_projects_in() const -> uint64_t { return _generation_of_folders_to_discover_projects_in; }
     void save() { _serializer.save(); }
 
 private:
+    uint64_t _generation_of_folders_to_discover_projects_in{0};
+
     Cool::JsonAutoSerializer _serializer{
         "user_settings_launcher.json",
         false /*autosave_when_destroyed*/, // This is a static instance, so saving it in the destructor is dangerous because we don't know when it will happen exactly. Instead, we call save manually in App::on_shutdown()
         [&](nlohmann::json const& json) {
             Cool::json_get(json, "Automatically install latest version", automatically_install_latest_version);
             Cool::json_get(json, "Automatically upgrade projects to latest compatible version", automatically_upgrade_projects_to_latest_compatible_version);
+            Cool::json_get(json, "Limit disk space used by versions", limit_disk_space_used_by_versions);
+            Cool::json_get(json, "Max disk space used by versions (GB)", max_disk_space_used_by_versions_in_GB);
+            Cool::json_get(json, "Discover projects automatically", discover_projects_automatically);
+            Cool::json_get(json, "Folders to discover projects in", folders_to_discover_projects_in);
+            Cool::json_get(json, "Extract AppImages at installation", extract_appimages_at_installation);
             /* Cool::json_get(json, "Show experimental versions", show_experimental_versions); */ // Don't serialize it because I don't want users to enable it once when I need to make them test something, then forget to disable it, and then see all the experimental versions and use them as if they were regular versions. Using an experimental version needs to be a very concious decision.
         },
         [&](nlohmann::json& json) {
             Cool::json_set(json, "Automatically install latest version", automatically_install_latest_version);
             Cool::json_set(json, "Automatically upgrade projects to latest compatible version", automatically_upgrade_projects_to_latest_compatible_version);
+            Cool::json_set(json, "Limit disk space used by versions", limit_disk_space_used_by_versions);
+            Cool::json_set(json, "Max disk space used by versions (GB)", max_disk_space_used_by_versions_in_GB);
+            Cool::json_set(json, "Discover projects automatically", discover_projects_automatically);
+            Cool::json_set(json, "Folders to discover projects in", folders_to_discover_projects_in);
+            Cool::json_set(json, "Extract AppImages at installation", extract_appimages_at_installation);
             /* Cool::json_set(json, "Show experimental versions", show_experimental_versions); */ // Don't serialize it because I don't want users to enable it once when I need to make them test something, then forget to disable it, and then see all the experimental versions and use them as if they were regular versions. Using an experimental version needs to be a very concious decision.
         },
         false /*use_shared_user_data*/
@@ -8,11 +8,36 @@ auto installed_versions_folder() -> std::filesystem::path
     return Cool::Path::user_data() / "Installed Versions";
 }
 
+auto installed_versions_index_file() -> std::filesystem::path
+{
+    return Cool::Path::user_data() / "installed_versions_index.txt";
+}
+
+auto versions_trash_folder() -> std::filesystem::path
+{
+    return Cool::Path::user_data() / "Installed Versions Trash";
+}
+
 auto projects_info_folder() -> std::filesystem::path
 {
     return Cool::Path::user_data() / "Projects Info";
 }
 
+auto projects_index_file() -> std::filesystem::path
+{
+    return Cool::Path::user_data() / "projects_index.txt";
+}
+
+auto projects_info_archive_folder() -> std::filesystem::path
+{
+    return Cool::Path::user_data() / "Projects Info Archive";
+}
+
+auto thumbnails_cache_folder() -> std::filesystem::path
+{
+    return Cool::Path::user_data() / "Thumbnails Cache";
+}
+
 auto default_projects_folder() -> std::filesystem::path
 {
     return Cool::Path::user_data() / "Projects";
@@ -23,4 +48,14 @@ auto versions_compatibility_file() -> std::filesystem::path
     return Cool::Path::user_data() / "versions_compatibility.txt";
 }
 
+auto launch_timelines_log_file() -> std::filesystem::path
+{
+    return Cool::Path::user_data() / "launch_timelines.log";
+}
+
+auto launch_timelines_trace_file() -> std::filesystem::path
+{
+    return Cool::Path::user_data() / "launch_timelines_trace.json";
+}
+
 } // namespace Path
\ No newline at end of file
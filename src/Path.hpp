@@ -4,10 +4,23 @@ namespace Path {
 
 /// Folder where all the Coollab releases will be installed
 auto installed_versions_folder() -> std::filesystem::path;
+/// File listing all the versions that are in installed_versions_folder(), so that we don't have to scan that folder on startup
+auto installed_versions_index_file() -> std::filesystem::path;
+/// Versions being uninstalled are first moved there, and then deleted in the background. Must be on the same drive as installed_versions_folder() so that moving is instantaneous
+auto versions_trash_folder() -> std::filesystem::path;
 /// Folder where all the projects info are stored, for all the projects that are tracked by the launcher
 auto projects_info_folder() -> std::filesystem::path;
+/// File listing all the projects that are tracked by the launcher, so that we can show them on startup without reading all the folders in projects_info_folder()
+auto projects_index_file() -> std::filesystem::path;
+/// The info folders of the projects that don't exist anymore are moved there, and deleted after a while. Must be on the same drive as projects_info_folder() so that moving is instantaneous
+auto projects_info_archive_folder() -> std::filesystem::path;
+/// Small versions of the projects' thumbnails, generated by the launcher so that it doesn't have to decode the full-size ones
+auto thumbnails_cache_folder() -> std::filesystem::path;
 /// Folder where all the projects are stored by default
 auto default_projects_folder() -> std::filesystem::path;
 auto versions_compatibility_file() -> std::filesystem::path;
+/// How long each step of the launches took, cf. LaunchTimelines
+auto launch_timelines_log_file() -> std::filesystem::path;
+auto launch_timelines_trace_file() -> std::filesystem::path;
 
 } // namespace Path
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "FileIdentity.hpp"
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+auto file_identity(std::filesystem::path const& path) -> std::optional<FileIdentity>
+{
+#if defined(_WIN32)
+    // FILE_FLAG_BACKUP_SEMANTICS allows us to open folders too. We don't ask for any access right, we only want the metadata
+    auto const handle = CreateFileW(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return std::nullopt;
+    auto       info    = BY_HANDLE_FILE_INFORMATION{};
+    bool const success = GetFileInformationByHandle(handle, &info);
+    CloseHandle(handle);
+    if (!success)
+        return std::nullopt;
+    return FileIdentity{
+        .device = info.dwVolumeSerialNumber,
+        .file   = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow,
+    };
+#else
+    struct stat info{};
+    if (stat(path.c_str(), &info) != 0)
+        return std::nullopt;
+    return FileIdentity{
+        .device = static_cast<uint64_t>(info.st_dev),
+        .file   = static_cast<uint64_t>(info.st_ino),
+    };
+#endif
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include <fstream>
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+TEST_CASE("file_identity() is the same for all the paths of a file")
+{
+    auto const folder = TemporaryFolder{"file_identity"};
+    std::filesystem::create_directories(folder / "sub");
+    std::ofstream{folder / "a.coollab"} << "a";
+    std::ofstream{folder / "b.coollab"} << "b";
+
+    auto const identity = file_identity(folder / "a.coollab");
+    REQUIRE(identity.has_value());
+    CHECK(file_identity(folder / "sub" / ".." / "a.coollab") == identity);
+    CHECK(file_identity(folder / "b.coollab") != identity);
+    CHECK(file_identity(folder / "missing.coollab") == std::nullopt);
+
+    auto error_code = std::error_code{};
+    std::filesystem::create_hard_link(folder / "a.coollab", folder / "link.coollab", error_code);
+    if (!error_code) // Not all file systems support hard links
+        CHECK(file_identity(folder / "link.coollab") == identity);
+}
+#endif
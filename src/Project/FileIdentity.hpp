@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+
+/// Identifies a file independently of the path used to reach it (symlinks, hard links, different case on a case-insensitive drive, etc.)
+/// This is (st_dev, st_ino) on Linux and macOS, and (volume serial number, file index) on Windows.
+/// It is only valid while the drive stays mounted, so we never store it on disk.
+struct FileIdentity {
+    uint64_t device{};
+    uint64_t file{};
+
+    friend auto operator==(FileIdentity const&, FileIdentity const&) -> bool = default;
+};
+
+template<>
+struct std::hash<FileIdentity> {
+    auto operator()(FileIdentity const& identity) const noexcept -> size_t
+    {
+        return std::hash<uint64_t>{}(identity.device * 0x9E3779B97F4A7C15ull ^ identity.file);
+    }
+};
+
+/// A single query to the file system. Returns std::nullopt if the file doesn't exist
+auto file_identity(std::filesystem::path const&) -> std::optional<FileIdentity>;
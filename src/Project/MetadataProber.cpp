@@ -0,0 +1,299 @@
+#include "MetadataProber.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include "read_project_version.hpp"
+#if defined(__APPLE__)
+#include <sys/mount.h>
+#endif
+
+auto probe_project_file(std::filesystem::path const& file_path) -> ProjectFileMetadata
+{
+    auto const identity        = file_identity(file_path); // Also tells us if the file exists
+    auto       error_code      = std::error_code{};
+    auto const time_of_version = std::filesystem::last_write_time(file_path, error_code); // Before reading the version, so that if the file changes in between the scan will read it again
+    return ProjectFileMetadata{
+        .file_exists     = identity.has_value(),
+        .version         = identity.has_value() ? read_project_version(file_path) : std::nullopt,
+        .file_identity   = identity,
+        .time_of_version = identity.has_value() && !error_code ? std::make_optional(static_cast<int64_t>(time_of_version.time_since_epoch().count())) : std::nullopt,
+    };
+}
+
+#if defined(__linux__)
+/// The mount points in /proc/self/mounts have their spaces, tabs, newlines and backslashes written as \040, \011, \012 and \134
+static auto unescape_mount_point(std::string const& str) -> std::string
+{
+    auto const is_octal = [](char c) {
+        return c >= '0' && c <= '7';
+    };
+    auto res = std::string{};
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+        if (str[i] == '\\' && i + 3 < str.size() && is_octal(str[i + 1]) && is_octal(str[i + 2]) && is_octal(str[i + 3]))
+        {
+            res += static_cast<char>((str[i + 1] - '0') * 64 + (str[i + 2] - '0') * 8 + (str[i + 3] - '0'));
+            i += 3;
+        }
+        else
+        {
+            res += str[i];
+        }
+    }
+    return res;
+}
+#endif
+
+/// Only returns the information that the OS already has in memory, without asking the drives (which might hang)
+static auto read_mount_points() -> std::vector<std::filesystem::path>
+{
+    auto res = std::vector<std::filesystem::path>{};
+#if defined(__linux__)
+    auto file = std::ifstream{"/proc/self/mounts"};
+    auto line = std::string{};
+    while (std::getline(file, line))
+    {
+        // "device mount_point type options dump pass"
+        auto fields      = std::istringstream{line};
+        auto device      = std::string{};
+        auto mount_point = std::string{};
+        if (fields >> device >> mount_point)
+            res.emplace_back(unescape_mount_point(mount_point));
+    }
+#elif defined(__APPLE__)
+    struct statfs* mounts    = nullptr;
+    int const      nb_mounts = getmntinfo(&mounts, MNT_NOWAIT); // MNT_NOWAIT returns the cached information instead of asking each file system
+    for (int i = 0; i < nb_mounts; ++i)
+        res.emplace_back(mounts[i].f_mntonname);
+#endif
+    // On Windows, the mount is the drive letter or the network share, which is the root name of the path
+    std::sort(res.begin(), res.end(), [](std::filesystem::path const& a, std::filesystem::path const& b) {
+        return a.native().size() > b.native().size();
+    });
+    return res;
+}
+
+static auto is_inside(std::filesystem::path const& path, std::filesystem::path const& folder) -> bool
+{
+    return std::mismatch(folder.begin(), folder.end(), path.begin(), path.end()).first == folder.end();
+}
+
+MetadataProber::MetadataProber()
+    : MetadataProber{Settings{}}
+{}
+
+MetadataProber::MetadataProber(Settings settings)
+    : _state{std::make_shared<State>()}
+{
+    _state->settings = std::move(settings);
+}
+
+MetadataProber::~MetadataProber()
+{
+    // We can't join the workers: one of them might be stuck on a drive that doesn't answer, and we don't want to hang when closing the launcher.
+    // They share the State with us, and stop as soon as their current probe returns.
+    auto lock             = std::unique_lock{_state->mutex};
+    _state->wants_to_stop = true;
+}
+
+auto MetadataProber::mount_point_of(std::filesystem::path const& file_path) -> std::filesystem::path
+{
+    if (_state->settings.mount_point_of)
+        return _state->settings.mount_point_of(file_path);
+
+    // Drives get mounted and unmounted while the launcher is running
+    auto const now = std::chrono::steady_clock::now();
+    if (_mount_points.empty() || now - _time_of_last_mount_points_update > std::chrono::seconds{5})
+    {
+        _mount_points                     = read_mount_points();
+        _time_of_last_mount_points_update = now;
+    }
+    for (auto const& mount_point : _mount_points)
+    {
+        if (is_inside(file_path, mount_point))
+            return mount_point;
+    }
+    return file_path.root_path();
+}
+
+void MetadataProber::request(std::filesystem::path const& file_path)
+{
+    auto const mount_point = mount_point_of(file_path).string();
+    auto const key         = file_path.string();
+
+    auto  lock  = std::unique_lock{_state->mutex};
+    auto& mount = _state->mounts[mount_point];
+    if (mount.is_unreachable)
+    {
+        if (mount.waiting_for_mount.insert(key).second)
+            _state->results.push_back({.file_path = file_path, .metadata = std::nullopt});
+        return;
+    }
+    if (!mount.queued.insert(key).second)
+        return;
+    mount.queue.push_back(file_path);
+    if (!mount.has_worker)
+    {
+        mount.has_worker = true;
+        std::thread{[state = _state, mount_point]() { work(state, mount_point); }}.detach();
+    }
+}
+
+auto MetadataProber::pop_results() -> std::vector<Result>
+{
+    auto       lock = std::unique_lock{_state->mutex};
+    auto const now  = std::chrono::steady_clock::now();
+    for (auto& [_, mount] : _state->mounts)
+    {
+        if (mount.is_unreachable || !mount.current_file.has_value() || now - mount.start_of_current_probe < _state->settings.timeout)
+            continue;
+
+        // Don't send any more queries to this mount, they would hang too. We will probe these files again once the current query returns
+        mount.is_unreachable = true;
+        _state->results.push_back({.file_path = *mount.current_file, .metadata = std::nullopt});
+        for (auto& file_path : mount.queue)
+        {
+            mount.waiting_for_mount.insert(file_path.string());
+            _state->results.push_back({.file_path = std::move(file_path), .metadata = std::nullopt});
+        }
+        mount.queue.clear();
+        mount.queued.clear();
+    }
+    return std::exchange(_state->results, {});
+}
+
+void MetadataProber::work(std::shared_ptr<State> const& state, std::string const& mount_point)
+{
+    while (true)
+    {
+        auto file_path = std::filesystem::path{};
+        {
+            auto  lock  = std::unique_lock{state->mutex};
+            auto& mount = state->mounts.at(mount_point);
+            if (state->wants_to_stop || mount.queue.empty())
+            {
+                mount.has_worker = false;
+                return;
+            }
+            file_path = std::move(mount.queue.front());
+            mount.queue.pop_front();
+            mount.queued.erase(file_path.string());
+            mount.current_file           = file_path;
+            mount.start_of_current_probe = std::chrono::steady_clock::now();
+        }
+
+        auto metadata = state->settings.probe(file_path);
+
+        {
+            auto  lock  = std::unique_lock{state->mutex};
+            auto& mount = state->mounts.at(mount_point);
+            mount.current_file.reset();
+            if (mount.is_unreachable)
+            {
+                // It answers again, so we can probe the files that have been requested in the meantime
+                mount.is_unreachable = false;
+                for (auto const& key : mount.waiting_for_mount)
+                {
+                    if (mount.queued.insert(key).second)
+                        mount.queue.emplace_back(key);
+                }
+                mount.waiting_for_mount.clear();
+            }
+            state->results.push_back({.file_path = std::move(file_path), .metadata = std::move(metadata)});
+        }
+    }
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include <atomic>
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+static auto wait_for_results(MetadataProber& prober, size_t nb_results) -> std::vector<MetadataProber::Result>
+{
+    auto       results  = std::vector<MetadataProber::Result>{};
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while (results.size() < nb_results && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        for (auto& result : prober.pop_results())
+            results.push_back(std::move(result));
+    }
+    return results;
+}
+
+TEST_CASE("MetadataProber doesn't let a drive that hangs block the other drives, nor the main thread")
+{
+    // Stands in for a network share that doesn't answer: the probes of the files in /slow only return once the test releases them
+    auto slow_drive_is_released = std::make_shared<std::atomic<bool>>(false);
+    auto prober                 = MetadataProber{{
+                        .probe = [=](std::filesystem::path const& file_path) {
+            if (file_path.string().starts_with("/slow"))
+            {
+                while (!*slow_drive_is_released)
+                    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            return ProjectFileMetadata{.file_exists = true, .version = VersionName::from("19.0.0")};
+        },
+                        .mount_point_of = [](std::filesystem::path const& file_path) {
+            return file_path.root_path() / *std::next(file_path.begin());
+        },
+                        .timeout = std::chrono::milliseconds{50},
+    }};
+
+    prober.request("/slow/a.coollab");
+    prober.request("/fast/b.coollab");
+    auto results = wait_for_results(prober, 1);
+    REQUIRE(results.size() == 1);
+    CHECK(results[0].file_path == "/fast/b.coollab");
+    CHECK(results[0].metadata.has_value());
+
+    // The main thread keeps running at full speed while the slow drive hangs
+    auto       longest_frame = std::chrono::steady_clock::duration{};
+    auto const end           = std::chrono::steady_clock::now() + std::chrono::milliseconds{200};
+    while (std::chrono::steady_clock::now() < end)
+    {
+        longest_frame = std::max(longest_frame, duration_of<std::chrono::steady_clock::duration>([&]() {
+                                     prober.request("/slow/c.coollab");
+                                     for (auto& result : prober.pop_results())
+                                         results.push_back(std::move(result));
+                                 }));
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    CHECK(longest_frame < std::chrono::milliseconds{5});
+
+    // After the timeout, the files of the slow drive are reported as unreachable, once each
+    REQUIRE(results.size() == 3);
+    CHECK(results[1].file_path == "/slow/a.coollab");
+    CHECK(!results[1].metadata.has_value());
+    CHECK(results[2].file_path == "/slow/c.coollab");
+    CHECK(!results[2].metadata.has_value());
+
+    // And they are probed again once the drive answers
+    *slow_drive_is_released = true;
+    results                 = wait_for_results(prober, 2);
+    REQUIRE(results.size() == 2);
+    CHECK(results[0].file_path == "/slow/a.coollab");
+    CHECK(results[0].metadata.has_value());
+    CHECK(results[1].file_path == "/slow/c.coollab");
+    CHECK(results[1].metadata.has_value());
+}
+
+TEST_CASE("MetadataProber reads the existence and version of a project file")
+{
+    auto const folder = TemporaryFolder{"MetadataProber"};
+    std::ofstream{folder / "project.coollab"} << "19.0.0\n{}";
+
+    auto prober = MetadataProber{};
+    prober.request(folder / "project.coollab");
+    prober.request(folder / "missing.coollab");
+    auto results = wait_for_results(prober, 2);
+    REQUIRE(results.size() == 2);
+    std::sort(results.begin(), results.end(), [](auto const& a, auto const& b) { return a.file_path < b.file_path; });
+    CHECK(!results[0].metadata->file_exists);
+    CHECK(results[1].metadata->file_exists);
+    CHECK(results[1].metadata->version == VersionName::from("19.0.0"));
+}
+#endif
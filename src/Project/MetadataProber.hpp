@@ -0,0 +1,79 @@
+#pragma once
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "FileIdentity.hpp"
+#include "Version/VersionName.hpp"
+
+struct ProjectFileMetadata {
+    bool                        file_exists{};
+    std::optional<VersionName>  version{};
+    std::optional<FileIdentity> file_identity{};
+    std::optional<int64_t>      time_of_version{}; // Last write time of the project file, read before its version, like in the ProjectsIndexEntry
+};
+
+/// Blocking, can hang for a long time on an unreachable drive
+auto probe_project_file(std::filesystem::path const& file_path) -> ProjectFileMetadata;
+
+/// Reads the metadata of the project files on background threads, so that a slow or unreachable drive (network share, USB drive that has been removed, etc.) never blocks the UI.
+/// There is one queue per mount point: a drive that hangs only delays the projects that live on it.
+/// When a query takes longer than the timeout, the whole mount is considered unreachable until that query returns, instead of piling up more queries that would hang too.
+class MetadataProber {
+public:
+    struct Result {
+        std::filesystem::path              file_path{};
+        std::optional<ProjectFileMetadata> metadata{}; // std::nullopt when the drive didn't answer in time. Another Result will come for this file once it answers
+    };
+    /// The functions can be replaced in the tests, to simulate drives that hang
+    struct Settings {
+        std::function<ProjectFileMetadata(std::filesystem::path const& file_path)>   probe{&probe_project_file}; // Called on the background threads
+        std::function<std::filesystem::path(std::filesystem::path const& file_path)> mount_point_of{}; // Defaults to looking for the path in the list of mount points of the OS
+        std::chrono::milliseconds                                                    timeout{std::chrono::seconds{2}};
+    };
+
+    MetadataProber();
+    explicit MetadataProber(Settings);
+    ~MetadataProber();
+    MetadataProber(MetadataProber const&)                    = delete;
+    auto operator=(MetadataProber const&) -> MetadataProber& = delete;
+    MetadataProber(MetadataProber&&)                         = delete;
+    auto operator=(MetadataProber&&) -> MetadataProber&      = delete;
+
+    /// Doesn't touch the file system (except for reading the list of mount points, which the OS keeps in memory), so it is fine to call it on the main thread
+    void request(std::filesystem::path const& file_path);
+    /// Call this once per frame. Returns the results that have arrived since the last call, and reports the requests that are stuck on a mount that doesn't answer
+    auto pop_results() -> std::vector<Result>;
+
+private:
+    struct Mount {
+        std::deque<std::filesystem::path>     queue{};
+        std::unordered_set<std::string>       queued{}; // So that a file that changes many times in a row is only probed once
+        bool                                  has_worker{false};
+        std::optional<std::filesystem::path>  current_file{};
+        std::chrono::steady_clock::time_point start_of_current_probe{};
+        bool                                  is_unreachable{false};
+        std::unordered_set<std::string>       waiting_for_mount{}; // Requested while the mount was unreachable, probed as soon as it answers again
+    };
+    /// Shared with the workers, because a worker stuck on a hung drive can't be interrupted and might outlive the MetadataProber
+    struct State {
+        Settings                               settings{};
+        std::unordered_map<std::string, Mount> mounts{};
+        std::vector<Result>                    results{};
+        bool                                   wants_to_stop{false};
+        std::mutex                             mutex{};
+    };
+    static void work(std::shared_ptr<State> const& state, std::string const& mount_point);
+    auto        mount_point_of(std::filesystem::path const& file_path) -> std::filesystem::path;
+
+private:
+    std::shared_ptr<State>                _state;
+    std::vector<std::filesystem::path>    _mount_points{}; // Sorted from longest to shortest, so that the first one that contains a path is its mount
+    std::chrono::steady_clock::time_point _time_of_last_mount_points_update{};
+};
@@ -5,6 +5,7 @@
 #include "Cool/ImGui/ImGuiExtras_dropdown.hpp"
 #include "Cool/Utils/overloaded.hpp"
 #include "LauncherSettings.hpp"
+#include "UpgradeDecisionsGeneration.hpp"
 #include "Version/VersionName.hpp"
 #include "VersionCompatibility/VersionCompatibility.hpp"
 #include "range/v3/view.hpp"
@@ -14,38 +15,91 @@ auto Project::name() const -> std::string
     return Cool::File::file_name_without_extension(_file_path).string();
 }
 
-auto Project::file_not_found() const -> bool
+auto Project::file_path() const -> std::filesystem::path const&
 {
-    auto const not_found = !Cool::File::exists(file_path());
-    if (not_found)
-        _version_name.invalidate_cache();
-    return not_found;
+    return _canonical_file_path.get_value([&]() {
+        return Cool::File::weakly_canonical(_file_path);
+    });
 }
 
-auto Project::current_version() const -> std::optional<VersionName>
+auto Project::info_folder_path() const -> std::filesystem::path const&
 {
-    return _version_name.get_value([&]() -> std::optional<VersionName> {
-        auto file = std::ifstream{file_path()};
-        if (!file.is_open())
-            return std::nullopt;
-        auto version = ""s;
-        std::getline(file, version);
-        return VersionName::from(version);
+    return _info_folder_path.get_value([&]() {
+        return Path::projects_info_folder() / Cool::hash_project_path_for_info_folder(file_path());
     });
 }
 
+auto Project::file_not_found() const -> bool
+{
+    return _file_not_found;
+}
+
+void Project::on_file_changed() const
+{
+    _is_being_probed = true;
+}
+
+void Project::set_file_metadata(std::optional<ProjectFileMetadata> const& metadata) const
+{
+    _drive_is_unreachable = !metadata.has_value();
+    if (!metadata.has_value())
+        return; // Keep what we knew, and wait for the drive to answer
+    _is_being_probed = false;
+    _file_identity   = metadata->file_identity;
+    _file_not_found  = !metadata->file_exists;
+    _version_name    = metadata->version;
+    _time_of_version = metadata->time_of_version;
+}
+
+void Project::on_info_changed() const
+{
+    _time_of_last_change.invalidate_cache();
+}
+
+auto Project::upgrade_decisions() const -> UpgradeDecisions&
+{
+    auto const generation = upgrade_decisions_generation().get(); // Read it before computing, so that if it changes while we compute we will recompute next time
+    auto const version    = current_version();
+    if (_upgrade_decisions.has_value() && _upgrade_decisions->generation == generation && _upgrade_decisions->current_version == version)
+        return *_upgrade_decisions;
+
+    _upgrade_decisions = UpgradeDecisions{
+        .generation                          = generation,
+        .current_version                     = version,
+        .version_to_upgrade_to_automatically = version && launcher_settings().automatically_upgrade_projects_to_latest_compatible_version
+                                                   ? version_compatibility().version_to_upgrade_to_automatically(*version)
+                                                   : VersionToUpgradeTo{DontUpgrade{}},
+    };
+    return *_upgrade_decisions;
+}
+
+auto Project::compatible_versions() const -> std::vector<VersionNameAndUpgradeInstructions> const&
+{
+    auto& decisions = upgrade_decisions();
+    if (!decisions.compatible_versions.has_value())
+    {
+        decisions.compatible_versions = decisions.current_version
+                                            ? version_compatibility().compatible_versions(*decisions.current_version)
+                                            : std::vector<VersionNameAndUpgradeInstructions>{};
+    }
+    return *decisions.compatible_versions;
+}
+
+void Project::set_version_to_upgrade_to_automatically(uint64_t generation, std::optional<VersionName> const& current_version, VersionToUpgradeTo const& version_to_upgrade_to) const
+{
+    _upgrade_decisions = UpgradeDecisions{
+        .generation                          = generation,
+        .current_version                     = current_version,
+        .version_to_upgrade_to_automatically = version_to_upgrade_to,
+    };
+}
+
 auto Project::version_to_upgrade_to() const -> VersionToUpgradeTo
 {
     if (_version_to_upgrade_to_selected_by_user.has_value())
         return *_version_to_upgrade_to_selected_by_user;
 
-    if (!launcher_settings().automatically_upgrade_projects_to_latest_compatible_version)
-        return DontUpgrade{};
-
-    if (!current_version())
-        return DontUpgrade{};
-
-    return version_compatibility().version_to_upgrade_to_automatically(*current_version());
+    return upgrade_decisions().version_to_upgrade_to_automatically;
 }
 
 auto Project::version_to_launch() const -> std::optional<VersionName>
@@ -63,6 +117,16 @@ auto Project::version_to_launch() const -> std::optional<VersionName>
     );
 }
 
+auto Project::as_index_entry() const -> ProjectsIndexEntry
+{
+    return ProjectsIndexEntry{
+        .file_path           = file_path(),
+        .time_of_last_change = static_cast<int64_t>(time_of_last_change().time_since_epoch().count()),
+        .time_of_version     = _time_of_version,
+        .version             = current_version(),
+    };
+}
+
 auto Project::time_of_last_change() const -> std::filesystem::file_time_type const&
 {
     return _time_of_last_change.get_value([&]() {
@@ -107,12 +171,19 @@ struct DropdownEntry_VersionToUpgradeTo {
     }
 };
 
-void Project::set_file_path(std::filesystem::path file_path)
+void Project::set_file_path(std::filesystem::path canonical_file_path)
 {
-    _file_path = std::move(file_path);
+    _file_path = std::move(canonical_file_path);
     _next_name = Cool::File::file_name_without_extension(_file_path).string();
-    _version_name.invalidate_cache();
+    _canonical_file_path.invalidate_cache();
+    _canonical_file_path.get_value([&]() { return _file_path; });
+    _info_folder_path.invalidate_cache();
+    _file_not_found = false; // We are only given paths that the user has just picked or renamed to
+    _version_name.reset();
+    _time_of_version.reset();
     _time_of_last_change.invalidate_cache();
+    _is_being_probed      = true; // Until the ProjectManager gets the result of its MetadataProber
+    _drive_is_unreachable = false;
 }
 
 void Project::imgui_version_to_upgrade_to()
@@ -127,7 +198,7 @@ void Project::imgui_version_to_upgrade_to()
         return;
     }
 
-    auto const compatible_versions = version_compatibility().compatible_versions(*current_version());
+    auto const& compatible_versions = this->compatible_versions();
     if (compatible_versions.empty())
     {
         Cool::ImGuiExtras::disabled_if(true, fmt::format("This project is already using the latest version compatible with {}", current_version()->as_string()).c_str(), [&]() {
@@ -2,9 +2,12 @@
 #include "Cool/File/File.h"
 #include "Cool/Utils/Cached.h"
 #include "Cool/Utils/hash_project_path_for_info_folder.hpp"
+#include "MetadataProber.hpp"
 #include "Path.hpp"
 #include "Version/VersionName.hpp"
 #include "Version/VersionToUpgradeTo.hpp"
+#include "VersionCompatibility/CompatibilityTable.hpp"
+#include "projects_index.hpp"
 
 class Project {
 public:
@@ -13,27 +16,81 @@ public:
         : _file_path{std::move(file_path)}
         , _next_name{Cool::File::file_name_without_extension(_file_path).string()}
     {}
+    /// Used when we already know the time of last change (and maybe the version), so that we don't have to ask the file system again
+    explicit Project(ProjectsIndexEntry const& entry)
+        : Project{entry.file_path}
+    {
+        _canonical_file_path.get_value([&]() { return entry.file_path; }); // The paths in the index are already canonical, and canonicalizing again would query the drive, which might be slow
+        _time_of_last_change.get_value([&]() { return std::filesystem::file_time_type{std::filesystem::file_time_type::duration{entry.time_of_last_change}}; });
+        _file_not_found  = !entry.time_of_version.has_value();
+        _version_name    = entry.version; // Even when the file was missing: it has no version then, and reading it again is the job of the MetadataProber, once the file comes back
+        _time_of_version = entry.time_of_version;
+        _file_identity   = entry.file_identity;
+    }
 
-    auto file_path() const -> std::filesystem::path { return Cool::File::weakly_canonical(_file_path); }
+    auto file_path() const -> std::filesystem::path const&;
     auto file_not_found() const -> bool;
     auto name() const -> std::string;
-    auto current_version() const -> std::optional<VersionName>;
+    /// std::nullopt if the project has no version, or if it hasn't been read yet. Never reads the project file, this is done in the background by the scan and the MetadataProber
+    auto current_version() const -> std::optional<VersionName> { return _version_name.value_or(std::nullopt); }
+    /// std::nullopt if the version hasn't been read yet
+    auto known_version() const -> std::optional<std::optional<VersionName>> const& { return _version_name; }
     auto version_to_upgrade_to() const -> VersionToUpgradeTo;
     auto version_to_launch() const -> std::optional<VersionName>;
     auto thumbnail_path() const -> std::filesystem::path { return info_folder_path() / "thumbnail.png"; }
     auto time_of_last_change() const -> std::filesystem::file_time_type const&;
-    auto info_folder_path() const -> std::filesystem::path { return Path::projects_info_folder() / Cool::hash_project_path_for_info_folder(file_path()); }
+    /// While "Make a copy" is running in the background
+    auto is_being_copied() const -> bool { return _is_being_copied; }
+    auto info_folder_path() const -> std::filesystem::path const&;
+    /// While the MetadataProber checks the project file in the background, after it has changed
+    auto is_being_probed() const -> bool { return _is_being_probed; }
+    /// When the drive of the project file didn't answer in time
+    auto drive_is_unreachable() const -> bool { return _drive_is_unreachable; }
+    /// std::nullopt until the project file has been checked in the background (by the scan or the MetadataProber)
+    auto file_identity() const -> std::optional<FileIdentity> const& { return _file_identity; }
 
-    void set_file_path(std::filesystem::path file_path);
+    /// `canonical_file_path` must already be canonical, so that we don't have to query the drive. The version will then be read by the MetadataProber
+    void set_file_path(std::filesystem::path canonical_file_path);
+    /// Called by the ProjectManager when its FilesWatcher tells it that the project file has been modified / created / deleted.
+    /// We keep the previous version and existence until set_file_metadata() gets called, so that we never query the drive (which might hang) on the main thread
+    void on_file_changed() const;
+    /// Called by the ProjectManager with the result of its MetadataProber. std::nullopt when the drive didn't answer in time
+    void set_file_metadata(std::optional<ProjectFileMetadata> const&) const;
+    /// Called when the path.txt in our info folder has been modified, which Coollab does every time it saves the project
+    void on_info_changed() const;
+    /// Doesn't touch the project file: uses the version and the last write time that have been read by the scan or the MetadataProber
+    auto as_index_entry() const -> ProjectsIndexEntry;
 
     void imgui_version_to_upgrade_to();
 
+private:
+    struct UpgradeDecisions {
+        uint64_t                                                      generation{};
+        std::optional<VersionName>                                    current_version{};
+        VersionToUpgradeTo                                            version_to_upgrade_to_automatically{};
+        std::optional<std::vector<VersionNameAndUpgradeInstructions>> compatible_versions{}; // Only computed when the UI needs it
+    };
+    /// Cached until the upgrade_decisions_generation() or our current version changes
+    auto upgrade_decisions() const -> UpgradeDecisions&;
+    auto compatible_versions() const -> std::vector<VersionNameAndUpgradeInstructions> const&;
+    /// Used by the ProjectManager when it computes the upgrades of all the projects at once
+    void set_version_to_upgrade_to_automatically(uint64_t generation, std::optional<VersionName> const& current_version, VersionToUpgradeTo const&) const;
+
 private:
     friend class ProjectManager;
 
     std::filesystem::path                                 _file_path{};
     std::string                                           _next_name{};
-    mutable Cool::Cached<std::optional<VersionName>>      _version_name{};
+    mutable Cool::Cached<std::filesystem::path>           _canonical_file_path{};
+    mutable Cool::Cached<std::filesystem::path>           _info_folder_path{};
+    mutable bool                                          _file_not_found{false}; // Until the index, the scan or the MetadataProber tells us otherwise
+    mutable std::optional<std::optional<VersionName>>     _version_name{};        // std::nullopt until the version has been read
+    mutable std::optional<int64_t>                        _time_of_version{};     // Last write time of the project file when _version_name was read
     std::optional<VersionToUpgradeTo>                     _version_to_upgrade_to_selected_by_user{std::nullopt};
+    bool                                                  _is_being_copied{false};
+    mutable bool                                          _is_being_probed{false};
+    mutable bool                                          _drive_is_unreachable{false};
+    mutable std::optional<FileIdentity>                   _file_identity{}; // Kept when renaming, because a rename doesn't change the identity of the file
     mutable Cool::Cached<std::filesystem::file_time_type> _time_of_last_change{};
+    mutable std::optional<UpgradeDecisions>               _upgrade_decisions{};
 };
\ No newline at end of file
@@ -1,61 +1,539 @@
 #include "ProjectManager.hpp"
+#include <cmath>
 #include <filesystem>
+#include <map>
+#include <unordered_map>
 #include <vector>
 #include "COOLLAB_FILE_EXTENSION.hpp"
 #include "Cool/File/File.h"
 #include "Cool/File/PathChecks.hpp"
 #include "Cool/ImGui/Fonts.h"
 #include "Cool/ImGui/ImGuiExtras.h"
-#include "Cool/TextureSource/TextureLibrary_Image.h"
-#include "Cool/TextureSource/default_textures.h"
+#include "Cool/Task/TaskManager.hpp"
+#include "Cool/Utils/hash_project_path_for_info_folder.hpp"
 #include "Cool/Utils/overloaded.hpp"
 #include "ImGuiNotify/ImGuiNotify.hpp"
+#include "LauncherSettings.hpp"
 #include "LongPaths/LongPathsChecker.hpp"
 #include "Path.hpp"
 #include "Project.hpp"
+#include "UpgradeDecisionsGeneration.hpp"
+#include "projects_index.hpp"
+#include "Version/VersionManager.hpp"
+#include "VersionCompatibility/VersionCompatibility.hpp"
 #include "boxer/boxer.h"
 #include "imgui.h"
+#include "imgui_fixed_height_rows.hpp"
 #include "open/open.hpp"
 
 ProjectManager::ProjectManager()
 {
-    try
+    auto projects_in_index = read_projects_index();
+    if (projects_in_index.has_value())
     {
-        for (auto const& entry : std::filesystem::directory_iterator{Path::projects_info_folder()})
+        // Show the projects right away. The scan will then check that the index is still up to date
+        _projects_are_from_index = true;
+        auto projects            = std::vector<Project>{};
+        for (auto const& entry : *projects_in_index)
         {
-            if (!entry.is_directory())
-            {
-                assert(false);
-                continue;
-            }
+            start_tracking(projects.emplace_back(entry));
+            _paths_in_index.insert(entry.file_path.string());
+        }
+        _projects.insert(std::move(projects));
+    }
+    // Else, this is the first time we run with an index: the scan will migrate all the projects from their info folder
+    _index_end_at_start_of_scan = projects_index_end();
+
+    Cool::task_manager().submit(std::make_shared<Task_ScanProjects>(_incoming_projects, projects_in_index.value_or(std::vector<ProjectsIndexEntry>{})));
+}
+
+void ProjectManager::receive_incoming_projects()
+{
+    if (_has_finished_loading_projects)
+        return;
 
-            auto file = std::ifstream{entry.path() / "path.txt"};
-            if (!file.is_open())
+    auto new_projects = std::vector<Project>{};
+    auto new_index    = std::optional<std::vector<ProjectsIndexEntry>>{};
+    {
+        std::unique_lock lock{_incoming_projects->mutex};
+        if (_projects_are_from_index && !_incoming_projects->scan_is_done)
+            return; // We already show the projects from the index, and will replace them all at once when the scan is done, instead of streaming them
+        std::swap(new_projects, _incoming_projects->projects);
+        std::swap(new_index, _incoming_projects->new_index);
+        _has_finished_loading_projects = _incoming_projects->scan_is_done;
+    }
+    if (new_index.has_value())
+        write_projects_index(*new_index, _index_end_at_start_of_scan); // Keeps the changes that we have appended while the scan was running. This is also how we migrate from the info folders to the index, the first time
+
+    if (_projects_are_from_index)
+    {
+        // Merge the result of the scan into the current list instead of replacing it, so that we keep what the user has done while the scan was running:
+        // the projects they have deleted or renamed don't come back, and the ones that have been added (created, copied, discovered, relinked) are not lost
+        auto scanned_projects = std::unordered_map<std::string, Project*>{};
+        for (auto& project : new_projects)
+            scanned_projects[project.file_path().string()] = &project;
+
+        auto ids_to_erase = std::vector<ProjectId>{};
+        for (auto const id : std::vector<ProjectId>{_projects.in_order(ProjectsOrder::MostRecent)}) // Copied, because reposition() changes the order
+        {
+            auto& project = _projects[id];
+            if (project.is_being_copied())
+                continue; // It is not in the index yet, and the copy will update it once it is done
+            auto const path = project.file_path().string();
+            auto const it   = scanned_projects.find(path);
+            if (it == scanned_projects.end())
             {
-                // TODO(Launcher) error
-                continue;
+                if (_paths_in_index.contains(path))
+                    ids_to_erase.push_back(id); // The scan has found that it doesn't exist anymore
+                continue;                       // Else, it has been added while the scan was running
             }
-            std::string path;
-            std::getline(file, path);
-            _projects.emplace_back(path);
+            auto scanned = std::move(*it->second);
+            scanned_projects.erase(it);
+            if (project._version_to_upgrade_to_selected_by_user.has_value())
+                scanned._version_to_upgrade_to_selected_by_user = project._version_to_upgrade_to_selected_by_user; // The user might have chosen it while the scan was running
+            project = std::move(scanned);
+            _projects.reposition(id);
+            _identity_index.insert_or_update(path, project.file_identity());
+            add_to_search_index(project);
+        }
+        for (auto const id : ids_to_erase)
+        {
+            stop_tracking(_projects[id]);
+            _selected_projects.erase(_projects[id].file_path().string());
+            _projects.erase(id);
+        }
+
+        // The projects that were in the index but not in the list anymore have been removed or renamed by the user while the scan was running
+        auto projects_to_add = std::vector<Project>{};
+        for (auto& project : new_projects)
+        {
+            auto const path = project.file_path().string();
+            if (scanned_projects.contains(path) && !_paths_in_index.contains(path))
+                projects_to_add.push_back(std::move(project));
+        }
+        new_projects = std::move(projects_to_add);
+        _paths_in_index.clear();
+        _projects_are_from_index = false;
+    }
+    for (auto const& project : new_projects)
+        start_tracking(project);
+
 #if defined(_WIN32)
-            long_paths_checker().check(path);
+    for (auto const& project : new_projects)
+        long_paths_checker().check(project.file_path());
 #endif
+    // The time of last change and the version have already been read by the scan, so sorting doesn't touch the file system
+    _projects.insert(std::move(new_projects));
+    _generation_of_upgrade_plan.reset();
+    _search_results_are_outdated = true;
+
+    if (_has_finished_loading_projects)
+        Cool::task_manager().submit(after(10s), std::make_shared<Task_CompactProjectsInfo>(_incoming_compaction)); // Once the startup is over, so that it doesn't compete with it for the disk
+}
+
+void ProjectManager::receive_finished_copies()
+{
+    std::erase_if(_copies_in_progress, [&](std::shared_ptr<ProjectCopy> const& copy) {
+        auto const status = copy->signal.status();
+        if (status == Status::Waiting)
+            return false;
+
+        auto const& ids = _projects.in_order(ProjectsOrder::MostRecent);
+        auto const  it  = std::find_if(ids.begin(), ids.end(), [&](ProjectId id) {
+            return _projects[id].file_path() == copy->destination;
+        });
+        if (status == Status::Completed)
+        {
+            if (it != ids.end())
+            {
+                auto const id = *it;
+                _projects[id] = Project{copy->entry};
+                _projects.reposition(id);
+                _identity_index.insert_or_update(_projects[id].file_path().string(), _projects[id].file_identity());
+                add_to_search_index(_projects[id]); // Its version is known now
+            }
+            else
+            {
+                start_tracking(_projects[_projects.insert(Project{copy->entry})]);
+            }
+            append_to_projects_index(copy->entry);
+        }
+        else if (it != ids.end())
+        {
+            auto const id = *it;
+            stop_tracking(_projects[id]);
+            _projects.erase(id);
+        }
+        _generation_of_upgrade_plan.reset();
+        _search_results_are_outdated = true;
+        return true;
+    });
+}
+
+auto ProjectManager::versions_used_by_projects() const -> std::vector<VersionName>
+{
+    auto res = std::vector<VersionName>{};
+    for (auto const& project : _projects)
+    {
+        // Keep the current version too, because the user can decide not to upgrade
+        if (auto const version = project.current_version())
+            res.push_back(*version);
+        if (auto const version = project.version_to_launch())
+            res.push_back(*version);
+    }
+    return res;
+}
+
+void ProjectManager::start_tracking(Project const& project)
+{
+    _files_watcher->watch(project.file_path());
+    _files_watcher->watch(project.info_folder_path() / "path.txt");
+    _files_watcher->watch(project.thumbnail_path());
+    _identity_index.insert_or_update(project.file_path().string(), project.file_identity());
+    add_to_search_index(project);
+}
+
+void ProjectManager::stop_tracking(Project const& project)
+{
+    _files_watcher->unwatch(project.file_path());
+    _files_watcher->unwatch(project.info_folder_path() / "path.txt");
+    _files_watcher->unwatch(project.thumbnail_path());
+    _identity_index.remove(project.file_path().string());
+    _search_index.remove(project.file_path().string());
+    _thumbnails.erase(project.thumbnail_path().string());
+    if (_thumbnails_cache)
+        _thumbnails_cache->invalidate(project.thumbnail_path()); // So that it gets loaded again if the project comes back
+    _search_results_are_outdated = true;
+}
+
+void ProjectManager::add_to_search_index(Project const& project)
+{
+    auto const& version = project.known_version(); // Reading it here would touch the file system on the main thread
+    if (!version.has_value())
+        _metadata_prober.request(project.file_path()); // receive_probed_metadata() will add it again once its version is known
+    _search_index.insert_or_update(project.file_path().string(), project.name(), project.file_path().string(), version && *version ? (*version)->as_string() : "");
+    _search_results_are_outdated = true;
+}
+
+void ProjectManager::update_search_results_ifn()
+{
+    if (!_search_results_are_outdated || _search_query.empty())
+        return;
+    _search_results_are_outdated = false;
+
+    auto score_of_project = std::unordered_map<std::string_view, int>{};
+    for (auto const& match : _search_index.search(_search_query))
+        score_of_project[match.key] = match.score;
+
+    _search_results.clear();
+    if (score_of_project.empty())
+        return;
+    for (auto const id : _projects.in_order(_order))
+    {
+        if (score_of_project.contains(_projects[id].file_path().string()))
+            _search_results.push_back(id);
+    }
+    // Stable, so that equally good matches stay in the order selected by the user
+    std::stable_sort(_search_results.begin(), _search_results.end(), [&](ProjectId a, ProjectId b) {
+        return score_of_project.at(_projects[a].file_path().string()) > score_of_project.at(_projects[b].file_path().string());
+    });
+}
+
+void ProjectManager::apply_files_changes()
+{
+    auto const changes = _files_watcher->pop_changes();
+    if (changes.everything_might_have_changed)
+    {
+        for (auto const& project : _projects)
+        {
+            project.on_file_changed();
+            _metadata_prober.request(project.file_path());
+            project.on_info_changed();
+            if (_thumbnails_cache)
+                _thumbnails_cache->invalidate(project.thumbnail_path());
+        }
+        // We don't update the positions of the projects, because it would read the path.txt of all the projects on the main thread. This is rare enough that an order being a bit outdated doesn't matter
+        return;
+    }
+    if (changes.paths.empty())
+        return; // This is the usual case: nothing has changed, and we don't touch the file system at all
+
+    auto projects_by_file      = std::unordered_map<std::string, ProjectId>{};
+    auto projects_by_info_file = std::unordered_map<std::string, ProjectId>{};
+    for (auto const id : _projects.in_order(ProjectsOrder::MostRecent))
+    {
+        projects_by_file[_projects[id].file_path().string()]                            = id;
+        projects_by_info_file[(_projects[id].info_folder_path() / "path.txt").string()] = id;
+    }
+    auto projects_to_reposition = std::unordered_set<ProjectId>{};
+    for (auto const& path : changes.paths)
+    {
+        if (auto const it = projects_by_file.find(path.string()); it != projects_by_file.end())
+        {
+            _projects[it->second].on_file_changed();
+            _metadata_prober.request(path); // Its version might have changed, but the project file might be on a slow drive, so we don't read it here
+        }
+        if (auto const it = projects_by_info_file.find(path.string()); it != projects_by_info_file.end())
+        {
+            _projects[it->second].on_info_changed(); // This is what happens when a project gets launched and saved by Coollab
+            projects_to_reposition.insert(it->second);
+        }
+        if (_thumbnails_cache && path.filename() == "thumbnail.png")
+            _thumbnails_cache->invalidate(path); // Doesn't do anything if this is not the thumbnail of one of our projects
+    }
+    // Each of them moves to its new place, without sorting the whole list again
+    for (auto const id : projects_to_reposition)
+        _projects.reposition(id);
+    if (!projects_to_reposition.empty())
+        _search_results_are_outdated = true;
+}
+
+void ProjectManager::receive_probed_metadata()
+{
+    auto const results = _metadata_prober.pop_results();
+    if (results.empty())
+        return;
+
+    auto projects_by_file = std::unordered_map<std::string, ProjectId>{};
+    for (auto const id : _projects.in_order(ProjectsOrder::MostRecent))
+        projects_by_file[_projects[id].file_path().string()] = id;
+    for (auto const& result : results)
+    {
+        auto const it = projects_by_file.find(result.file_path.string());
+        if (it == projects_by_file.end())
+            continue; // The project has been removed or renamed in the meantime
+        _projects[it->second].set_file_metadata(result.metadata);
+        if (!result.metadata.has_value())
+            continue;
+        if (_paths_to_write_to_index.erase(it->first))
+            append_to_projects_index(_projects[it->second].as_index_entry());
+        _identity_index.insert_or_update(it->first, _projects[it->second].file_identity());
+        add_to_search_index(_projects[it->second]); // Its version might have changed
+        _projects.reposition(it->second);
+    }
+    _generation_of_upgrade_plan.reset();
+    _search_results_are_outdated = true;
+}
+
+void ProjectManager::receive_discovered_projects()
+{
+    if (!_has_finished_loading_projects)
+        return; // Otherwise we couldn't tell which projects are new
+
+    std::erase_if(_stopping_crawlers, [](std::unique_ptr<ProjectsCrawler> const& crawler) {
+        return crawler->has_stopped();
+    });
+
+    if (_generation_of_crawler_roots != launcher_settings().generation_of_folders_to_discover_projects_in())
+    {
+        _generation_of_crawler_roots = launcher_settings().generation_of_folders_to_discover_projects_in();
+        auto roots                   = launcher_settings().folders_to_discover_projects_in_including_default();
+        if (!_crawler || _crawler->roots() != roots)
+        {
+            if (_crawler)
+            {
+                _crawler->request_stop();
+                _stopping_crawlers.push_back(std::move(_crawler));
+            }
+            if (!roots.empty())
+                _crawler = std::make_unique<ProjectsCrawler>(ProjectsCrawler::Settings{.roots = std::move(roots), .projects_info_folder = Path::projects_info_folder()});
+        }
+    }
+    if (!_crawler)
+        return;
+
+    auto const entries = _crawler->pop_found_projects();
+    if (entries.empty())
+        return;
+    auto duplicate_info_folders = std::vector<std::filesystem::path>{};
+    for (auto const& entry : entries)
+    {
+        auto const known_project = _identity_index.find(entry.file_path.string(), entry.file_identity);
+        if (known_project.has_value())
+        {
+            if (*known_project != entry.file_path.string())
+                duplicate_info_folders.push_back(Path::projects_info_folder() / Cool::hash_project_path_for_info_folder(entry.file_path)); // The same file, reached through another path (hard link, bind mount, etc.)
+            continue;
         }
+        start_tracking(_projects[_projects.insert(Project{entry})]);
+        append_to_projects_index(entry);
+    }
+    if (!duplicate_info_folders.empty())
+        Cool::task_manager().submit(std::make_shared<Task_DeleteDuplicateProjectsInfo>(std::move(duplicate_info_folders)));
+    _generation_of_upgrade_plan.reset();
+    _search_results_are_outdated = true;
+}
+
+void ProjectManager::receive_deleted_projects()
+{
+    auto file_paths = std::vector<std::filesystem::path>{};
+    {
+        std::unique_lock lock{_incoming_deleted_projects->mutex};
+        std::swap(file_paths, _incoming_deleted_projects->file_paths);
+    }
+    if (!file_paths.empty())
+        append_removals_to_projects_index(file_paths);
+}
+
+void ProjectManager::receive_projects_info_compaction()
+{
+    auto compaction        = std::optional<ProjectsInfoCompaction>{};
+    auto archived_projects = std::vector<std::filesystem::path>{};
+    {
+        std::unique_lock lock{_incoming_compaction->mutex};
+        std::swap(compaction, _incoming_compaction->compaction);
+        std::swap(archived_projects, _incoming_compaction->archived_projects);
     }
-    catch (std::exception const&)
+    if (!archived_projects.empty())
+        append_removals_to_projects_index(archived_projects);
+    if (!compaction.has_value())
+        return;
+    if (!compaction->removed_projects.empty())
+        append_removals_to_projects_index(compaction->removed_projects);
+
+    auto removed_projects = std::unordered_set<std::string>{};
+    for (auto const& path : compaction->removed_projects)
+        removed_projects.insert(path.string());
+    for (auto const& project : _projects)
+    {
+        if (!project.is_being_copied() && removed_projects.contains(project.file_path().string()))
+            stop_tracking(project);
+    }
+    // The projects whose info folders have been merged appear several times in the list, with the same path. Only keep one of them
+    // (without calling stop_tracking(), because the one we keep is tracked under the same path)
+    auto merged_projects = std::unordered_set<std::string>{};
+    for (auto const& path : compaction->projects_with_merged_duplicates)
+        merged_projects.insert(path.string());
+    auto kept_merged_projects = std::unordered_set<std::string>{};
+    _projects.erase_if([&](Project const& project) {
+        if (project.is_being_copied())
+            return false;
+        auto const path = project.file_path().string();
+        return removed_projects.contains(path)
+               || (merged_projects.contains(path) && !kept_merged_projects.insert(path).second);
+    });
+    for (auto const& path : removed_projects)
+        _selected_projects.erase(path);
+
+    if (!compaction->missing_projects.empty())
+    {
+        _missing_projects                 = std::move(compaction->missing_projects);
+        _user_agreed_to_remove_missing_projects = std::make_shared<bool>(false);
+        static constexpr size_t max_nb_projects_to_show{5};
+        auto                    content = std::string{"They haven't been opened for a while, and their file doesn't exist anymore. Maybe they have been moved or renamed (you can relink them with \"Find project file\"), maybe they are on a drive that is not connected, or maybe they have been deleted:\n"};
+        for (size_t i = 0; i < std::min(_missing_projects.size(), max_nb_projects_to_show); ++i)
+            content += _missing_projects[i].file_path.string() + '\n';
+        if (_missing_projects.size() > max_nb_projects_to_show)
+            content += fmt::format("and {} more\n", _missing_projects.size() - max_nb_projects_to_show);
+        _missing_projects_notification = ImGuiNotify::send({
+            .type                 = ImGuiNotify::Type::Warning,
+            .title                = _missing_projects.size() == 1 ? "A project has not been found"s : fmt::format("{} projects have not been found", _missing_projects.size()),
+            .content              = content,
+            .custom_imgui_content = [user_agreed = _user_agreed_to_remove_missing_projects]() {
+                if (ImGui::Button("Remove them from the list"))
+                    *user_agreed = true;
+                ImGui::SetItemTooltip("%s", "Their files are not touched: if they come back, you can open them again with \"Open external project\"");
+            },
+            .duration = std::nullopt,
+        });
+    }
+    _generation_of_upgrade_plan.reset();
+    _search_results_are_outdated = true;
+}
+
+void ProjectManager::remove_missing_projects_ifn()
+{
+    if (!_user_agreed_to_remove_missing_projects || !*_user_agreed_to_remove_missing_projects)
+        return;
+    _user_agreed_to_remove_missing_projects.reset();
+    if (_missing_projects_notification.has_value())
+        ImGuiNotify::close_immediately(*_missing_projects_notification);
+    _missing_projects_notification.reset();
+
+    // Some of them might have been found again (or relinked) in the meantime
+    auto projects_to_remove = std::unordered_set<std::string>{};
+    for (auto const& project : _projects)
+    {
+        if (project.file_not_found())
+            projects_to_remove.insert(project.file_path().string());
+    }
+    std::erase_if(_missing_projects, [&](ProjectInfoFolder const& project) {
+        return !projects_to_remove.contains(project.file_path.string());
+    });
+    projects_to_remove.clear();
+    for (auto const& project : _missing_projects)
+        projects_to_remove.insert(project.file_path.string());
+
+    for (auto const& project : _projects)
     {
-        // TODO(Launcher) error
-        // return fmt::format("{}", e.what());
+        if (projects_to_remove.contains(project.file_path().string()))
+            stop_tracking(project);
     }
-    std::sort(_projects.begin(), _projects.end(), [](Project const& a, Project const& b) {
-        return a.time_of_last_change() > b.time_of_last_change();
+    _projects.erase_if([&](Project const& project) {
+        return projects_to_remove.contains(project.file_path().string());
     });
+    for (auto const& path : projects_to_remove)
+        _selected_projects.erase(path);
+    Cool::task_manager().submit(std::make_shared<Task_ArchiveProjectsInfo>(std::exchange(_missing_projects, {}), _incoming_compaction));
+    _generation_of_upgrade_plan.reset();
+    _search_results_are_outdated = true;
 }
 
-static auto project_name_error_message(std::string const& name, std::string const& current_name, std::filesystem::path const& new_path) -> std::optional<std::string>
+void ProjectManager::plan_upgrades_ifn()
 {
-    if (Cool::File::exists(new_path) && name != current_name)
+    auto const generation = upgrade_decisions_generation().get(); // Read it before computing, so that if it changes while we compute we will plan again next time
+    if (_generation_of_upgrade_plan == generation)
+        return;
+    _generation_of_upgrade_plan = generation;
+
+    auto current_versions = std::vector<VersionName>{};
+    auto projects         = std::vector<Project const*>{};
+    for (auto const& project : _projects)
+    {
+        if (auto const version = project.current_version())
+        {
+            current_versions.push_back(*version);
+            projects.push_back(&project);
+        }
+    }
+
+    if (!launcher_settings().automatically_upgrade_projects_to_latest_compatible_version)
+    {
+        _versions_to_upgrade_to.clear();
+        return; // Each project will cache DontUpgrade on its own, without querying the VersionCompatibility
+    }
+
+    auto plan = version_compatibility().plan_upgrades(current_versions);
+    for (size_t i = 0; i < projects.size(); ++i)
+        projects[i]->set_version_to_upgrade_to_automatically(generation, current_versions[i], plan.version_to_upgrade_to[i]);
+    _versions_to_upgrade_to = std::move(plan.versions_to_upgrade_to);
+}
+
+void ProjectManager::imgui_install_versions_needed_by_upgrades()
+{
+    auto versions_to_install = std::vector<VersionName>{};
+    for (auto const& version : _versions_to_upgrade_to)
+    {
+        if (version_manager().is_not_installed(version))
+            versions_to_install.push_back(version);
+    }
+    if (versions_to_install.empty())
+        return;
+
+    auto const label = versions_to_install.size() == 1
+                           ? fmt::format("Install {}, that some of your projects will be upgraded to", versions_to_install[0].as_string())
+                           : fmt::format("Install the {} versions that your projects will be upgraded to", versions_to_install.size());
+    if (ImGui::Button(label.c_str()))
+    {
+        for (auto const& version : versions_to_install)
+            version_manager().install_ifn(version);
+    }
+    ImGui::SetItemTooltip("%s", "So that your projects open right away when you launch them, instead of having to wait for the installation");
+}
+
+static auto project_name_error_message(std::string const& name, std::string const& current_name, bool new_path_is_taken) -> std::optional<std::string>
+{
+    if (new_path_is_taken && name != current_name)
         return "Name already used by another project";
 
     if (name.empty())
@@ -92,38 +570,260 @@ static auto project_name_error_message(std::string const& name, std::string cons
     return std::nullopt;
 }
 
-void ProjectManager::imgui(std::function<void(Project const&)> const& launch_project)
+static constexpr float thumbnail_size{100.f};
+static constexpr float thumbnail_frame_thickness{4.f};
+
+void ProjectManager::delete_projects(std::unordered_set<std::string> const& file_paths)
+{
+    auto projects_to_delete = std::vector<ProjectToDelete>{};
+    auto name               = std::string{};
+    for (auto const& project : _projects)
+    {
+        if (!project.is_being_copied() && file_paths.contains(project.file_path().string()))
+        {
+            projects_to_delete.push_back({.file_path = project.file_path(), .info_folder_path = project.info_folder_path()});
+            name = project.name();
+        }
+    }
+    if (projects_to_delete.empty())
+        return;
+
+    auto const title = projects_to_delete.size() == 1 ? fmt::format("Deleting project \"{}\"", name) : fmt::format("Deleting {} projects", projects_to_delete.size());
+    if (boxer::Selection::OK != boxer::show("Are you sure? This cannot be undone", title.c_str(), boxer::Style::Warning, boxer::Buttons::OKCancel))
+        return;
+
+    for (auto const& project : _projects)
+    {
+        if (!project.is_being_copied() && file_paths.contains(project.file_path().string()))
+            stop_tracking(project);
+    }
+    _projects.erase_if([&](Project const& project) {
+        return !project.is_being_copied() && file_paths.contains(project.file_path().string());
+    });
+    for (auto const& path : file_paths)
+        _selected_projects.erase(path);
+    Cool::task_manager().submit(std::make_shared<Task_DeleteProjects>(std::move(projects_to_delete), _incoming_deleted_projects));
+    _generation_of_upgrade_plan.reset();
+    _search_results_are_outdated = true;
+}
+
+void ProjectManager::on_row_clicked_with_modifier(size_t row, std::function<ProjectId(size_t row)> const& project_index)
 {
-    auto project_to_remove = _projects.end();
-    auto project_to_add    = std::optional<Project>{};
-    for (auto it = _projects.begin(); it != _projects.end(); ++it)
+    auto const path = _projects[project_index(row)].file_path().string();
+    if (!ImGui::GetIO().KeyShift || !_selection_anchor.has_value())
+    {
+        if (!_selected_projects.erase(path))
+            _selected_projects.insert(path);
+        _selection_anchor = path;
+        return;
+    }
+
+    // Find the anchor among the rows that are currently displayed. It might not be there anymore (e.g. the search query has changed since), in which case we only select this row
+    auto anchor_row = row;
+    for (size_t i = 0; i < (_search_query.empty() ? _projects.size() : _search_results.size()); ++i)
+    {
+        if (_projects[project_index(i)].file_path().string() == *_selection_anchor)
+        {
+            anchor_row = i;
+            break;
+        }
+    }
+    for (size_t i = std::min(row, anchor_row); i <= std::max(row, anchor_row); ++i)
     {
-        // Items that are outside of the view can be "clipped". We still need to render them because otherwise ImGui doesn't know the
-        // size of the whole dropdown list. But we can skip loading the texture, which is the only thing that actually costs some performance anyways.
-        bool const is_visible = ImGui::GetWindowPos().y - 1000.f < ImGui::GetCursorScreenPos().y
-                                && ImGui::GetCursorScreenPos().y < ImGui::GetWindowPos().y + ImGui::GetWindowSize().y;
+        if (!_projects[project_index(i)].is_being_copied())
+            _selected_projects.insert(_projects[project_index(i)].file_path().string());
+    }
+}
 
-        auto& project = *it;
+void ProjectManager::imgui_selection_actions()
+{
+    if (ImGui::SmallButton("Select missing projects"))
+    {
+        for (auto const& project : _projects)
+        {
+            if (project.file_not_found()) // Already known for all the projects that come from the scan or the index, so this doesn't touch the file system
+                _selected_projects.insert(project.file_path().string());
+        }
+    }
+    ImGui::SetItemTooltip("%s", "Select all the projects whose file has been moved or deleted, e.g. to remove them from the list all at once");
+    if (_selected_projects.empty())
+        return;
+
+    ImGui::SameLine();
+    ImGui::TextUnformatted(fmt::format("{} selected:", _selected_projects.size()).c_str());
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Delete"))
+        delete_projects(_selected_projects);
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Upgrade..."))
+        ImGui::OpenPopup("##upgrade_selected_projects");
+    if (ImGui::BeginPopup("##upgrade_selected_projects"))
+    {
+        auto version_to_upgrade_to = std::optional<std::optional<VersionToUpgradeTo>>{};
+        if (ImGui::Selectable("Upgrade automatically"))
+            version_to_upgrade_to = std::optional<VersionToUpgradeTo>{};
+        ImGui::SetItemTooltip("%s", "Use the latest compatible version if the \"Automatically upgrade projects\" setting is enabled, otherwise don't upgrade");
+        if (ImGui::Selectable("Don't upgrade"))
+            version_to_upgrade_to = std::optional<VersionToUpgradeTo>{DontUpgrade{}};
+        if (version_to_upgrade_to.has_value())
+        {
+            for (auto& project : _projects)
+            {
+                if (_selected_projects.contains(project.file_path().string()))
+                    project._version_to_upgrade_to_selected_by_user = *version_to_upgrade_to;
+            }
+        }
+        ImGui::EndPopup();
+    }
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Reveal in File Explorer"))
+    {
+        // Open each folder only once, even if it contains many of the selected projects
+        auto folders = std::map<std::filesystem::path, std::vector<Project const*>>{};
+        for (auto const& project : _projects)
+        {
+            if (_selected_projects.contains(project.file_path().string()))
+                folders[Cool::File::without_file_name(project.file_path())].push_back(&project);
+        }
+        for (auto const& [folder, projects] : folders)
+        {
+            if (projects.size() == 1 && !projects[0]->file_not_found())
+                Cool::open_focused_in_explorer(projects[0]->file_path());
+            else
+                Cool::open_folder_in_explorer(Cool::File::find_closest_existing_folder(folder));
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Deselect all"))
+    {
+        _selected_projects.clear();
+        _selection_anchor.reset();
+    }
+}
+
+auto ProjectManager::thumbnails_cache() -> ThumbnailsCache&
+{
+    // On screens with a high DPI, a thumbnail covers more pixels than its size in the UI, and we need a bigger image for it to look sharp
+    auto const size_in_pixels = static_cast<size_t>(std::ceil(thumbnail_size * std::max(1.f, ImGui::GetIO().DisplayFramebufferScale.x)));
+    if (!_thumbnails_cache || _thumbnails_cache->size() != size_in_pixels)
+        _thumbnails_cache = std::make_unique<ThumbnailsCache>(Path::thumbnails_cache_folder(), size_in_pixels);
+    return *_thumbnails_cache;
+}
+
+static auto order_name(ProjectsOrder order) -> const char*
+{
+    switch (order)
+    {
+    case ProjectsOrder::MostRecent:
+        return "Most recent";
+    case ProjectsOrder::Name:
+        return "Name";
+    case ProjectsOrder::Version:
+        return "Version";
+    }
+    return "";
+}
+
+void ProjectManager::imgui_order_selector()
+{
+    ImGui::SetNextItemWidth(ImGui::CalcTextSize(order_name(ProjectsOrder::MostRecent)).x + ImGui::GetFrameHeight() + 2.f * ImGui::GetStyle().FramePadding.x);
+    if (ImGui::BeginCombo("##order", order_name(_order)))
+    {
+        for (auto const order : {ProjectsOrder::MostRecent, ProjectsOrder::Name, ProjectsOrder::Version})
+        {
+            if (ImGui::Selectable(order_name(order), order == _order))
+            {
+                _order                       = order; // All the orders are always up to date, so this doesn't sort anything
+                _search_results_are_outdated = true;
+            }
+        }
+        ImGui::EndCombo();
+    }
+    ImGui::SetItemTooltip("%s", "Sort by");
+}
+
+static auto project_row_height() -> float
+{
+    auto const& style = ImGui::GetStyle();
+    // The title, and then the thumbnail which is always taller than the text next to it
+    float const title_height     = Cool::Font::bold()->FontSize + 2.f * style.SeparatorTextPadding.y + style.ItemSpacing.y;
+    float const thumbnail_height = thumbnail_size + 2.f * thumbnail_frame_thickness;
+    return title_height + thumbnail_height;
+}
+
+void ProjectManager::imgui(std::function<void(Project const&)> const& launch_project)
+{
+    receive_incoming_projects();
+    receive_finished_copies();
+    apply_files_changes();
+    receive_probed_metadata();
+    receive_discovered_projects();
+    receive_projects_info_compaction();
+    receive_deleted_projects();
+    remove_missing_projects_ifn();
+    plan_upgrades_ifn();
+    imgui_install_versions_needed_by_upgrades();
+
+    imgui_order_selector();
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(-FLT_MIN);
+    if (ImGui::InputTextWithHint("##search", "Search projects", &_search_query))
+        _search_results_are_outdated = true;
+    update_search_results_ifn();
+    auto const nb_rows       = _search_query.empty() ? _projects.size() : _search_results.size();
+    auto const project_index = [&](size_t row) {
+        return _search_query.empty() ? _projects.in_order(_order)[row] : _search_results[row];
+    };
+
+    imgui_selection_actions();
+
+    auto& thumbnails                = thumbnails_cache();
+    auto  projects_to_delete        = std::optional<std::unordered_set<std::string>>{};
+    auto  project_to_add            = std::optional<Project>{};
+    auto  project_to_reposition     = std::optional<ProjectId>{};
+    auto  row_clicked_with_modifier = std::optional<size_t>{};
+    // Only the visible rows are rendered, so the cost of a frame doesn't depend on the number of projects
+    auto const visible_rows = imgui_fixed_height_rows(nb_rows, project_row_height(), [&](size_t row) {
+        auto const id          = project_index(row);
+        auto&      project     = _projects[id];
+        bool const is_selected = _selected_projects.contains(project.file_path().string());
         ImGui::PushID(&project);
         ImGui::PushFont(Cool::Font::bold());
         ImGui::SeparatorText(project.name().c_str());
         ImGui::PopFont();
+        if (project.is_being_copied())
+        {
+            ImGui::TextDisabled("Copying...");
+            ImGui::PopID();
+            return;
+        }
 
         auto const rename_popup_id = ImGui::GetID("##rename");
 
         auto const widget = [&]() {
-            Cool::Texture const* thumbnail = is_visible ? Cool::TextureLibrary_Image::instance().get(project.thumbnail_path(), 1s) : &Cool::dummy_texture();
+            // The small thumbnails are generated and decoded in the background, we only upload them on the main thread
+            thumbnails.request(project.thumbnail_path(), 0 /*priority*/);
+            auto const           thumbnail_it = _thumbnails.find(project.thumbnail_path().string());
+            Cool::Texture const* thumbnail    = thumbnail_it != _thumbnails.end() ? &thumbnail_it->second : nullptr;
             if (thumbnail)
             {
-                Cool::ImGuiExtras::image_framed(thumbnail->imgui_texture_id(), {100.f, 100.f}, {
-                                                                                                   .frame_thickness       = 4.f,
-                                                                                                   .background_texture_id = _checkerboard_texture.get({100, 100}).imgui_texture_id(),
-                                                                                               });
-                ImGui::SameLine();
+                Cool::ImGuiExtras::image_framed(thumbnail->imgui_texture_id(), {thumbnail_size, thumbnail_size}, {
+                                                                                                                     .frame_thickness       = thumbnail_frame_thickness,
+                                                                                                                     .background_texture_id = _checkerboard_texture.get({100, 100}).imgui_texture_id(),
+                                                                                                                 });
             }
+            else
+            {
+                ImGui::Dummy({thumbnail_size + 2.f * thumbnail_frame_thickness, thumbnail_size + 2.f * thumbnail_frame_thickness}); // Keep the text aligned while the thumbnail is loading, and when there is none
+            }
+            ImGui::SameLine();
             ImGui::BeginGroup();
             ImGui::TextUnformatted(project.file_path().string().c_str());
-            if (project.current_version().has_value())
+            if (project.drive_is_unreachable())
+                Cool::ImGuiExtras::warning_text("The drive is not responding");
+            else if (project.is_being_probed())
+                ImGui::TextDisabled("Checking the project file...");
+            else if (project.current_version().has_value())
                 ImGui::TextUnformatted(project.current_version()->as_string().c_str());
             else if (project.file_not_found())
                 Cool::ImGuiExtras::warning_text("Project file not found");
@@ -149,21 +849,23 @@ void ProjectManager::imgui(std::function<void(Project const&)> const& launch_pro
                     });
                     if (path.has_value())
                     {
-                        std::optional<std::string> project_with_same_path{};
-                        for (auto const& proj : _projects)
-                        {
-                            if (&proj != &project && Cool::File::equivalent(proj.file_path(), *path))
-                            {
-                                project_with_same_path = proj.name();
-                                break;
-                            }
-                        }
-                        if (!project_with_same_path.has_value())
+                        // A single query to the file system, instead of comparing the file with each of the projects
+                        auto const identity               = file_identity(*path);
+                        auto const canonical_path         = Cool::File::weakly_canonical(*path);
+                        auto const project_with_same_path = _identity_index.find(canonical_path.string(), identity);
+                        if (!project_with_same_path.has_value() || *project_with_same_path == project.file_path().string())
                         {
                             auto const old_info_folder_path = project.info_folder_path();
-                            project.set_file_path(*path);
+                            auto const old_file_path        = project.file_path();
+                            stop_tracking(project);
+                            project.set_file_path(canonical_path);
+                            project._file_identity = identity;
                             Cool::File::rename(old_info_folder_path, project.info_folder_path());
-                            Cool::File::set_content(project.info_folder_path() / "path.txt", Cool::File::weakly_canonical(*path).string());
+                            Cool::File::set_content(project.info_folder_path() / "path.txt", canonical_path.string());
+                            append_removal_to_projects_index(old_file_path);
+                            _paths_to_write_to_index.insert(canonical_path.string());
+                            start_tracking(project); // Requests its version from the MetadataProber
+                            project_to_reposition = id; // Can't move it right away, we are iterating over the projects
 #if defined(_WIN32)
                             long_paths_checker().check(project.file_path());
 #endif
@@ -173,7 +875,7 @@ void ProjectManager::imgui(std::function<void(Project const&)> const& launch_pro
                             ImGuiNotify::send({
                                 .type    = ImGuiNotify::Type::Warning,
                                 .title   = fmt::format("Invalid path \"{}\"", Cool::File::weakly_canonical(*path)),
-                                .content = fmt::format("\"{}\" already uses this path. You cannot assign it to \"{}\"", *project_with_same_path, project.name()),
+                                .content = fmt::format("\"{}\" already uses this path. You cannot assign it to \"{}\"", Cool::File::file_name_without_extension(*project_with_same_path).string(), project.name()),
                             });
                         }
                     }
@@ -181,29 +883,44 @@ void ProjectManager::imgui(std::function<void(Project const&)> const& launch_pro
             }
             ImGui::EndGroup();
         };
+        bool const has_modifier = ImGui::GetIO().KeyCtrl || ImGui::GetIO().KeyShift;
         if (project.file_not_found())
         {
+            if (is_selected)
+            {
+                auto const min = ImGui::GetCursorScreenPos();
+                auto const max = ImVec2{min.x + ImGui::GetContentRegionAvail().x, min.y + thumbnail_size + 2.f * thumbnail_frame_thickness};
+                ImGui::GetWindowDrawList()->AddRectFilled(min, max, ImGui::GetColorU32(ImGuiCol_Header));
+            }
             ImGui::BeginGroup();
             widget();
             ImGui::EndGroup();
         }
         else
         {
-            if (Cool::ImGuiExtras::big_selectable(widget))
+            if (Cool::ImGuiExtras::big_selectable(widget, is_selected) && !has_modifier)
+            {
+                if (_crawler)
+                    _crawler->pause_for(std::chrono::seconds{10}); // Leave the disk to Coollab while it loads the project
                 launch_project(project);
+            }
         }
+        if (has_modifier && ImGui::IsItemClicked())
+            row_clicked_with_modifier = row;
         if (ImGui::BeginPopupContextItem("##project_context_menu"))
         {
             Cool::ImGuiExtras::disabled_if(project.file_not_found(), "File not found", [&]() {
                 if (ImGui::Selectable("Make a copy"))
                 {
-                    auto const new_path = Cool::File::find_available_path(project.file_path(), Cool::PathChecks{});
-                    Cool::File::copy_file(project.file_path(), new_path);
-
-                    project_to_add = Project{new_path};
-
-                    Cool::File::copy_file(project.info_folder_path() / "thumbnail.png", project_to_add->info_folder_path() / "thumbnail.png");
-                    Cool::File::set_content(project_to_add->info_folder_path() / "path.txt", Cool::File::weakly_canonical(new_path).string());
+                    // The copy shows up in the list right away, as pending, and the files get copied in the background
+                    auto copy         = std::make_shared<ProjectCopy>();
+                    copy->destination = Cool::File::weakly_canonical(Cool::File::find_available_path(project.file_path(), Cool::PathChecks{}));
+                    Cool::File::set_content(copy->destination, ""); // Reserve the name, so that making another copy before this one is done doesn't pick the same one
+                    project_to_add                   = Project{copy->destination};
+                    project_to_add->_is_being_copied = true;
+                    Cool::task_manager().submit(std::make_shared<Task_CopyProject>(project.file_path(), project.info_folder_path(), project_to_add->info_folder_path(), copy));
+                    _copies_in_progress.push_back(std::move(copy));
+                    start_tracking(*project_to_add);
 #if defined(_WIN32)
                     long_paths_checker().check(project_to_add->file_path());
 #endif
@@ -211,15 +928,8 @@ void ProjectManager::imgui(std::function<void(Project const&)> const& launch_pro
                 if (ImGui::Selectable("Rename"))
                     ImGui::OpenPopup(rename_popup_id);
             });
-            if (ImGui::Selectable("Delete project"))
-            {
-                if (boxer::Selection::OK == boxer::show("Are you sure? This cannot be undone", fmt::format("Deleting project \"{}\"", project.name()).c_str(), boxer::Style::Warning, boxer::Buttons::OKCancel))
-                {
-                    Cool::File::remove_folder(project.info_folder_path());
-                    Cool::File::remove_file(project.file_path());
-                    project_to_remove = it;
-                }
-            }
+            if (ImGui::Selectable(is_selected && _selected_projects.size() > 1 ? "Delete selected projects" : "Delete project"))
+                projects_to_delete = is_selected ? _selected_projects : std::unordered_set<std::string>{project.file_path().string()}; // Can't delete them right away, we are iterating over the projects
 
             project.imgui_version_to_upgrade_to();
 
@@ -247,9 +957,20 @@ void ProjectManager::imgui(std::function<void(Project const&)> const& launch_pro
         if (ImGui::BeginPopup("##rename"))
         {
             if (ImGui::IsWindowAppearing())
+            {
                 ImGui::SetKeyboardFocusHere();
-            auto       new_path  = Cool::File::with_extension(Cool::File::without_file_name(project.file_path()) / project._next_name, COOLLAB_FILE_EXTENSION);
-            auto const maybe_err = project_name_error_message(project._next_name, project.name(), new_path);
+                _rename_check.reset(); // Files might have been created since the last time the popup was open
+            }
+            auto new_path = Cool::File::with_extension(Cool::File::without_file_name(project.file_path()) / project._next_name, COOLLAB_FILE_EXTENSION);
+            if (!_rename_check.has_value() || _rename_check->new_path != new_path)
+            {
+                // Only touch the file system when the name changes, not every frame. And not at all when the name is used by one of our projects
+                _rename_check = RenameCheck{
+                    .new_path          = new_path,
+                    .new_path_is_taken = _identity_index.contains(new_path.string()) || Cool::File::exists(new_path),
+                };
+            }
+            auto const maybe_err = project_name_error_message(project._next_name, project.name(), _rename_check->new_path_is_taken);
             if (ImGui::InputText("##name", &project._next_name, ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_AutoSelectAll))
             {
                 if (!maybe_err.has_value())
@@ -259,11 +980,17 @@ void ProjectManager::imgui(std::function<void(Project const&)> const& launch_pro
                     {
                         new_path                   = Cool::File::find_available_path(new_path, Cool::PathChecks{});
                         auto const old_info_folder = project.info_folder_path();
+                        auto const old_file_path   = project.file_path();
                         if (Cool::File::rename(project.file_path(), new_path))
                         {
-                            project.set_file_path(new_path);
+                            stop_tracking(project);
+                            project.set_file_path(new_path); // Already canonical, because it is next to the previous path, which was
                             Cool::File::rename(old_info_folder, project.info_folder_path());
-                            Cool::File::set_content(project.info_folder_path() / "path.txt", Cool::File::weakly_canonical(new_path).string());
+                            Cool::File::set_content(project.info_folder_path() / "path.txt", new_path.string());
+                            append_removal_to_projects_index(old_file_path);
+                            _paths_to_write_to_index.insert(new_path.string());
+                            start_tracking(project); // Requests its version from the MetadataProber
+                            project_to_reposition = id; // Can't move it right away, we are iterating over the projects
 #if defined(_WIN32)
                             long_paths_checker().check(new_path);
 #endif
@@ -284,9 +1011,41 @@ void ProjectManager::imgui(std::function<void(Project const&)> const& launch_pro
             ImGui::EndPopup();
         }
         ImGui::PopID();
+    });
+    // Prepare the thumbnails of the rows that are about to become visible, the closest ones first
+    auto const nb_rows_to_prefetch = visible_rows.end - visible_rows.begin; // One screen above and one screen below
+    for (size_t distance = 1; distance <= nb_rows_to_prefetch; ++distance)
+    {
+        if (distance <= visible_rows.begin)
+            thumbnails.request(_projects[project_index(visible_rows.begin - distance)].thumbnail_path(), distance);
+        if (visible_rows.end + distance - 1 < nb_rows)
+            thumbnails.request(_projects[project_index(visible_rows.end + distance - 1)].thumbnail_path(), distance);
     }
-    if (project_to_remove != _projects.end())
-        _projects.erase(project_to_remove);
+    for (auto const& loaded_thumbnail : thumbnails.end_frame())
+    {
+        // An invalidated thumbnail keeps showing its previous version until the new one is here
+        if (loaded_thumbnail.pixels.has_value())
+        {
+            auto const& pixels = *loaded_thumbnail.pixels;
+            _thumbnails.insert_or_assign(loaded_thumbnail.thumbnail_path.string(), Cool::Texture{img::Size{static_cast<img::Size::DataType>(pixels.width), static_cast<img::Size::DataType>(pixels.height)}, 4, pixels.data.data()});
+        }
+        else
+        {
+            _thumbnails.erase(loaded_thumbnail.thumbnail_path.string());
+        }
+    }
+    if (row_clicked_with_modifier.has_value())
+        on_row_clicked_with_modifier(*row_clicked_with_modifier, project_index);
+    if (projects_to_delete.has_value())
+        delete_projects(*projects_to_delete);
+    if (project_to_reposition.has_value())
+        _projects.reposition(*project_to_reposition);
     if (project_to_add.has_value())
-        _projects.insert(_projects.begin(), *project_to_add);
+    {
+        _projects.insert(std::move(*project_to_add));
+        _generation_of_upgrade_plan.reset();
+        _search_results_are_outdated = true;
+    }
+    if (!_has_finished_loading_projects)
+        ImGui::TextDisabled("Loading projects...");
 }
\ No newline at end of file
@@ -1,6 +1,21 @@
 #pragma once
+#include <unordered_map>
+#include <unordered_set>
 #include "Cool/CheckerboardTexture/CheckerboardTexture.hpp"
+#include "Cool/Gpu/Texture.h"
+#include "FilesWatcher/FilesWatcher.hpp"
+#include "ImGuiNotify/ImGuiNotify.hpp"
+#include "MetadataProber.hpp"
 #include "Project.hpp"
+#include "ProjectsCrawler.hpp"
+#include "ProjectsIdentityIndex.hpp"
+#include "ProjectsList.hpp"
+#include "ProjectsSearchIndex.hpp"
+#include "Task_CompactProjectsInfo.hpp"
+#include "Task_CopyProject.hpp"
+#include "Task_DeleteProjects.hpp"
+#include "Task_ScanProjects.hpp"
+#include "Thumbnails/ThumbnailsCache.hpp"
 
 class ProjectManager {
 public:
@@ -8,7 +23,89 @@ public:
 
     void imgui(std::function<void(Project const&)> const& launch_project);
 
+    /// The projects are shown right away from the index, and then checked in the background. If there is no index yet, they appear in the list as they get found
+    auto has_finished_loading_projects() const -> bool { return _has_finished_loading_projects; }
+
+    /// All the versions that a project might be launched with, so that we never uninstall them automatically
+    auto versions_used_by_projects() const -> std::vector<VersionName>;
+
+private:
+    void receive_incoming_projects();
+    void receive_finished_copies();
+    /// Watches the files of the project, and adds it to the search index. Must be called every time a project is added to the list or renamed
+    void start_tracking(Project const&);
+    void stop_tracking(Project const&);
+    /// Invalidates the caches of the projects whose files have changed
+    void apply_files_changes();
+    /// Updates the projects whose files have been checked by the MetadataProber
+    void receive_probed_metadata();
+    /// Starts, restarts or stops the ProjectsCrawler according to the LauncherSettings, and adds the projects it has found
+    void receive_discovered_projects();
+    /// Removes from the list the projects whose info folder has been archived, and asks the user what to do with the ones whose file is missing
+    void receive_projects_info_compaction();
+    /// Removes from the index the projects that the Task_DeleteProjects have deleted
+    void receive_deleted_projects();
+    void remove_missing_projects_ifn();
+    /// Computes the automatic upgrades of all the projects in one batch, instead of letting each project query the VersionCompatibility on its own
+    void plan_upgrades_ifn();
+    void imgui_install_versions_needed_by_upgrades();
+    void add_to_search_index(Project const&);
+    void update_search_results_ifn();
+    /// Asks for confirmation once, removes the projects from the list right away, and deletes their files in the background
+    void delete_projects(std::unordered_set<std::string> const& file_paths);
+    /// The buttons that apply to all the selected projects at once
+    void imgui_selection_actions();
+    /// Ctrl+click toggles a project, Shift+click selects all the rows between the last clicked one and this one
+    void on_row_clicked_with_modifier(size_t row, std::function<ProjectId(size_t row)> const& project_index);
+    /// Lets the user choose between the orders that the ProjectsList maintains
+    void imgui_order_selector();
+    /// Recreates the cache when the size of the thumbnails in pixels changes (e.g. when the window moves to a screen with a different DPI)
+    auto thumbnails_cache() -> ThumbnailsCache&;
+
 private:
-    std::vector<Project>      _projects{};
-    Cool::CheckerboardTexture _checkerboard_texture{};
+    ProjectsList                      _projects{};
+    ProjectsOrder                     _order{ProjectsOrder::MostRecent};
+    std::shared_ptr<IncomingProjects> _incoming_projects{std::make_shared<IncomingProjects>()};
+    bool                              _has_finished_loading_projects{false};
+    bool                              _projects_are_from_index{false}; // Until the scan finishes and confirms them
+    std::unordered_set<std::string>   _paths_in_index{};               // Until the scan finishes, to tell the projects that the user has added or removed in the meantime from the ones that the scan has found or not found
+    uintmax_t                         _index_end_at_start_of_scan{};   // The scan's index is a snapshot of this point, the changes appended after it are kept when writing it
+    Cool::CheckerboardTexture         _checkerboard_texture{};
+    std::unique_ptr<FilesWatcher>     _files_watcher{make_files_watcher()};
+    MetadataProber                    _metadata_prober{};
+    std::unordered_set<std::string>   _paths_to_write_to_index{}; // The projects that have been renamed or relinked. They are written to the index once the MetadataProber has read their version
+    std::unique_ptr<ThumbnailsCache>  _thumbnails_cache{};
+    std::unique_ptr<ProjectsCrawler>  _crawler{}; // Only when the user has enabled the discovery of projects
+
+    std::unordered_map<std::string, Cool::Texture> _thumbnails{}; // Uploaded from the pixels that the ThumbnailsCache has loaded, keyed by the path of the full-size thumbnail
+
+    std::vector<std::unique_ptr<ProjectsCrawler>> _stopping_crawlers{};           // Destroyed once their threads have stopped, so that the UI never waits for a slow drive
+    std::optional<uint64_t>                       _generation_of_crawler_roots{}; // std::nullopt until the crawler has been started once
+
+    std::vector<std::shared_ptr<ProjectCopy>> _copies_in_progress{}; // Their Project is already in _projects, as pending
+    std::shared_ptr<IncomingDeletedProjects>  _incoming_deleted_projects{std::make_shared<IncomingDeletedProjects>()};
+
+    std::shared_ptr<IncomingProjectsInfoCompaction> _incoming_compaction{std::make_shared<IncomingProjectsInfoCompaction>()};
+    std::vector<ProjectInfoFolder>                  _missing_projects{};                       // Waiting for the user's consent to remove them from the list
+    std::shared_ptr<bool>                           _user_agreed_to_remove_missing_projects{}; // Set by the notification that asks for consent
+    std::optional<ImGuiNotify::NotificationId>      _missing_projects_notification{};
+
+    std::unordered_set<std::string> _selected_projects{}; // The file paths of the selected projects, because the ProjectIds change when a project is removed and added again (e.g. when it is renamed)
+    std::optional<std::string>      _selection_anchor{};  // The last project that has been Ctrl+clicked, from which Shift+click extends the selection
+
+    ProjectsIdentityIndex _identity_index{}; // Kept up to date by start_tracking() and stop_tracking(), like the search index
+
+    struct RenameCheck {
+        std::filesystem::path new_path{};
+        bool                  new_path_is_taken{};
+    };
+    std::optional<RenameCheck> _rename_check{}; // For the name currently typed in the rename popup
+
+    ProjectsSearchIndex    _search_index{};
+    std::string            _search_query{};
+    std::vector<ProjectId> _search_results{};                  // The projects that match _search_query, best matches first
+    bool                   _search_results_are_outdated{true}; // When the query, the order or the list of projects have changed
+
+    std::optional<uint64_t>  _generation_of_upgrade_plan{}; // std::nullopt when the list of projects has changed and we need to plan again
+    std::vector<VersionName> _versions_to_upgrade_to{};     // Deduplicated, the ones that at least one project will be upgraded to
 };
\ No newline at end of file
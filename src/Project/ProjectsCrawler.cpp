@@ -0,0 +1,372 @@
+#include "ProjectsCrawler.hpp"
+#include <algorithm>
+#include <iterator>
+#include "COOLLAB_FILE_EXTENSION.hpp"
+#include "Cool/File/File.h"
+#include "Cool/Utils/hash_project_path_for_info_folder.hpp"
+#include "FileIdentity.hpp"
+#include "lower_io_priority_of_current_thread.hpp"
+#include "read_project_version.hpp"
+
+static auto is_project_file(std::filesystem::path const& path) -> bool
+{
+    static auto const extension = Cool::File::with_extension("project", COOLLAB_FILE_EXTENSION).extension();
+    return path.extension() == extension;
+}
+
+ProjectsCrawler::ProjectsCrawler(Settings settings)
+    : _settings{std::move(settings)}
+{
+    for (auto const& root : _settings.roots)
+    {
+        if (_known_folders.insert(root.string()).second)
+            _folders_to_read.push_back(root);
+    }
+    _time_of_next_read_of_unwatched_folders = std::chrono::steady_clock::now() + _settings.delay_between_reads_of_unwatched_folders;
+    _nb_running_workers                     = std::max(_settings.nb_threads, 1u);
+    for (size_t i = 0; i < _nb_running_workers; ++i)
+    {
+        _workers.emplace_back([this]() {
+            work();
+            auto lock = std::unique_lock{_mutex};
+            _nb_running_workers--;
+        });
+    }
+}
+
+ProjectsCrawler::~ProjectsCrawler()
+{
+    request_stop();
+    for (auto& worker : _workers)
+        worker.join();
+}
+
+void ProjectsCrawler::request_stop()
+{
+    {
+        auto lock      = std::unique_lock{_mutex};
+        _wants_to_stop = true;
+    }
+    _condition.notify_all();
+}
+
+auto ProjectsCrawler::has_stopped() const -> bool
+{
+    auto lock = std::unique_lock{_mutex};
+    return _nb_running_workers == 0;
+}
+
+auto ProjectsCrawler::pop_found_projects() -> std::vector<ProjectsIndexEntry>
+{
+    auto lock = std::unique_lock{_mutex};
+    return std::exchange(_found_projects, {});
+}
+
+void ProjectsCrawler::pause_for(std::chrono::milliseconds duration)
+{
+    auto lock     = std::unique_lock{_mutex};
+    _end_of_pause = std::max(_end_of_pause, std::chrono::steady_clock::now() + duration);
+}
+
+auto ProjectsCrawler::has_finished_first_crawl() const -> bool
+{
+    auto lock = std::unique_lock{_mutex};
+    return _has_finished_first_crawl;
+}
+
+auto ProjectsCrawler::wait_for_turn(std::unique_lock<std::mutex>& lock) -> bool
+{
+    while (true)
+    {
+        auto const now           = std::chrono::steady_clock::now();
+        auto const time_of_read = std::max(_time_of_next_read, _end_of_pause);
+        if (now >= time_of_read)
+        {
+            _time_of_next_read = now + std::chrono::microseconds{1'000'000 / std::max(_settings.max_folders_read_per_second, 1u)};
+            return true;
+        }
+        if (_condition.wait_until(lock, time_of_read, [&]() { return _wants_to_stop; }))
+            return false;
+    }
+}
+
+void ProjectsCrawler::work()
+{
+    lower_io_priority_of_current_thread();
+
+    auto lock = std::unique_lock{_mutex};
+    while (true)
+    {
+        _condition.wait_for(lock, _settings.delay_between_checks_of_changes, [&]() { return _wants_to_stop || !_folders_to_read.empty(); });
+        if (_wants_to_stop)
+            return;
+        if (_folders_to_read.empty())
+        {
+            // Incremental updates: only read again the folders whose content has changed
+            auto changes = _files_watcher->pop_changes();
+            if (changes.everything_might_have_changed)
+                std::copy(_known_folders.begin(), _known_folders.end(), std::back_inserter(changes.paths));
+            for (auto& folder : changes.paths)
+                _folders_to_read.push_back(std::move(folder));
+            // And, once in a while, the ones we can't watch
+            if (std::chrono::steady_clock::now() >= _time_of_next_read_of_unwatched_folders)
+            {
+                _time_of_next_read_of_unwatched_folders = std::chrono::steady_clock::now() + _settings.delay_between_reads_of_unwatched_folders;
+                for (auto const& folder : _unwatched_folders)
+                    _folders_to_read.emplace_back(folder);
+            }
+            continue;
+        }
+
+        if (!wait_for_turn(lock))
+            return;
+        if (_folders_to_read.empty())
+            continue; // Another worker took it while we were waiting
+        auto const folder = std::move(_folders_to_read.front());
+        _folders_to_read.pop_front();
+        _nb_folders_being_read++;
+
+        lock.unlock();
+        read_folder(folder);
+        lock.lock();
+
+        _nb_folders_being_read--;
+        if (_folders_to_read.empty() && _nb_folders_being_read == 0)
+            _has_finished_first_crawl = true;
+    }
+}
+
+void ProjectsCrawler::read_folder(std::filesystem::path const& folder)
+{
+    // Watch before reading, so that we don't miss the files created while we read
+    bool should_watch{false};
+    {
+        auto lock = std::unique_lock{_mutex};
+        if (!_watched_folders.contains(folder.string()))
+        {
+            if (_watched_folders.size() < _settings.max_nb_watched_folders)
+            {
+                _watched_folders.insert(folder.string());
+                should_watch = true;
+            }
+            else
+            {
+                _unwatched_folders.insert(folder.string());
+            }
+        }
+    }
+    if (should_watch)
+        _files_watcher->watch_folder_content(folder);
+
+    auto error_code = std::error_code{};
+    auto it         = std::filesystem::directory_iterator{folder, std::filesystem::directory_options::skip_permission_denied, error_code};
+    if (error_code)
+    {
+        // The folder has been deleted. If it gets created again, its parent will tell us
+        _files_watcher->unwatch_folder_content(folder);
+        auto lock = std::unique_lock{_mutex};
+        _known_folders.erase(folder.string());
+        _watched_folders.erase(folder.string());
+        _unwatched_folders.erase(folder.string());
+        return;
+    }
+
+    auto subfolders    = std::vector<std::filesystem::path>{};
+    auto project_files = std::vector<std::filesystem::path>{};
+    for (; it != std::filesystem::directory_iterator{}; it.increment(error_code))
+    {
+        if (error_code)
+            break;
+        auto const& entry = *it;
+        if (entry.path().filename().string().starts_with('.'))
+            continue; // Hidden folders (.git, .cache, etc.) can be huge, and nobody saves their projects there
+        if (entry.is_symlink(error_code))
+            continue; // They could create cycles, or make us walk the same folders twice
+        if (entry.is_directory(error_code))
+            subfolders.push_back(entry.path());
+        else if (is_project_file(entry.path()))
+            project_files.push_back(entry.path());
+    }
+
+    {
+        auto lock = std::unique_lock{_mutex};
+        for (auto& subfolder : subfolders)
+        {
+            if (_known_folders.insert(subfolder.string()).second)
+                _folders_to_read.push_back(std::move(subfolder));
+        }
+    }
+    _condition.notify_all();
+
+    for (auto const& file_path : project_files)
+        register_project_ifn(file_path);
+}
+
+void ProjectsCrawler::register_project_ifn(std::filesystem::path const& path)
+{
+    auto const file_path   = Cool::File::weakly_canonical(path); // So that it is the same as Project::file_path(), which is what we use everywhere else
+    auto const info_folder = _settings.projects_info_folder / Cool::hash_project_path_for_info_folder(file_path);
+    auto const path_file   = info_folder / "path.txt";
+    auto       error_code  = std::error_code{};
+    if (std::filesystem::exists(path_file, error_code))
+        return; // Already known by the launcher
+
+    auto const time_of_version = std::filesystem::last_write_time(file_path, error_code);
+    if (error_code)
+        return; // Deleted in the meantime
+    std::filesystem::create_directories(info_folder, error_code);
+    if (!Cool::File::set_content(path_file, file_path.string()))
+        return;
+    // Use the last write time of the project rather than now, so that the projects we discover don't all appear at the top of the list
+    std::filesystem::last_write_time(path_file, time_of_version, error_code);
+
+    auto entry = ProjectsIndexEntry{
+        .file_path           = file_path,
+        .time_of_last_change = static_cast<int64_t>(std::filesystem::last_write_time(path_file, error_code).time_since_epoch().count()),
+        .time_of_version     = static_cast<int64_t>(time_of_version.time_since_epoch().count()),
+        .version             = read_project_version(file_path),
+        .file_identity       = file_identity(file_path),
+    };
+    auto lock = std::unique_lock{_mutex};
+    _found_projects.push_back(std::move(entry));
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include <fstream>
+#include <set>
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+static auto wait_for_projects(ProjectsCrawler& crawler, size_t nb_projects) -> std::vector<ProjectsIndexEntry>
+{
+    auto       projects = std::vector<ProjectsIndexEntry>{};
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (projects.size() < nb_projects && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        for (auto& project : crawler.pop_found_projects())
+            projects.push_back(std::move(project));
+    }
+    return projects;
+}
+
+static auto wait_for_first_crawl(ProjectsCrawler& crawler) -> bool
+{
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (!crawler.has_finished_first_crawl() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    return crawler.has_finished_first_crawl();
+}
+
+TEST_CASE("ProjectsCrawler finds all the projects of a big tree of folders, and then the ones that get created")
+{
+    auto const folder      = TemporaryFolder{"ProjectsCrawler"};
+    auto const root        = folder / "root";
+    auto const info_folder = folder / "Projects Info";
+
+    // 10 * 10 * 10 leaf folders, with a project in one folder out of 7, and some other files everywhere
+    size_t nb_projects{0};
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto const leaf = root / std::to_string(i / 100) / std::to_string(i / 10 % 10) / std::to_string(i % 10);
+        std::filesystem::create_directories(leaf);
+        std::ofstream{leaf / "image.png"} << "not a project";
+        if (i % 7 == 0)
+        {
+            std::ofstream{leaf / fmt::format("project {}.coollab", i)} << "19.0.0\n{}";
+            nb_projects++;
+        }
+    }
+    // These ones must be ignored
+    std::filesystem::create_directories(root / ".hidden");
+    std::ofstream{root / ".hidden" / "hidden.coollab"} << "19.0.0\n{}";
+    std::filesystem::create_directory_symlink(root / "0", root / "link to 0");
+
+    auto crawler = ProjectsCrawler{{
+        .roots                           = {root},
+        .projects_info_folder            = info_folder,
+        .max_folders_read_per_second     = 1'000'000,
+        .nb_threads                      = 4,
+        .delay_between_checks_of_changes = std::chrono::milliseconds{10},
+    }};
+    REQUIRE(wait_for_first_crawl(crawler));
+    auto projects = wait_for_projects(crawler, nb_projects);
+    CHECK(projects.size() == nb_projects);
+    CHECK(crawler.pop_found_projects().empty());
+
+    auto paths = std::unordered_set<std::string>{};
+    for (auto const& project : projects)
+    {
+        paths.insert(project.file_path.string());
+        CHECK(project.version == VersionName::from("19.0.0"));
+        CHECK(project.time_of_last_change == project.time_of_version); // They don't all appear as the most recent projects
+        CHECK(std::filesystem::exists(info_folder / Cool::hash_project_path_for_info_folder(project.file_path) / "path.txt"));
+    }
+    CHECK(paths.size() == nb_projects);
+
+    SUBCASE("The projects that are already registered are not registered again")
+    {
+        auto other_crawler = ProjectsCrawler{{
+            .roots                = {root},
+            .projects_info_folder = info_folder,
+            .nb_threads           = 4,
+        }};
+        REQUIRE(wait_for_first_crawl(other_crawler));
+        CHECK(other_crawler.pop_found_projects().empty());
+    }
+    SUBCASE("The projects created later are found without walking everything again")
+    {
+        std::ofstream{root / "5" / "5" / "5" / "new.coollab"} << "19.0.0\n{}";
+        std::filesystem::create_directories(root / "5" / "new folder");
+        std::ofstream{root / "5" / "new folder" / "new in new folder.coollab"} << "19.0.0\n{}";
+        projects = wait_for_projects(crawler, 2);
+        REQUIRE(projects.size() == 2);
+        auto names = std::set<std::string>{projects[0].file_path.filename().string(), projects[1].file_path.filename().string()};
+        CHECK(names == std::set<std::string>{"new.coollab", "new in new folder.coollab"});
+    }
+}
+
+TEST_CASE("ProjectsCrawler is throttled")
+{
+    auto const folder = TemporaryFolder{"ProjectsCrawler throttling"};
+    for (int i = 0; i < 20; ++i)
+        std::filesystem::create_directories(folder / "root" / std::to_string(i));
+    std::ofstream{folder / "root" / "project.coollab"} << "19.0.0\n{}";
+
+    auto const begin   = std::chrono::steady_clock::now();
+    auto       crawler = ProjectsCrawler{{
+              .roots                       = {folder / "root"},
+              .projects_info_folder        = folder / "Projects Info",
+              .max_folders_read_per_second = 100,
+    }};
+    crawler.pause_for(std::chrono::milliseconds{100});
+    REQUIRE(wait_for_first_crawl(crawler));
+    // 100ms of pause, and then 21 folders at 100 folders per second
+    CHECK(std::chrono::steady_clock::now() - begin > std::chrono::milliseconds{250});
+    CHECK(crawler.pop_found_projects().size() == 1);
+}
+
+TEST_CASE("ProjectsCrawler reads the folders it can't watch periodically")
+{
+    auto const folder = TemporaryFolder{"ProjectsCrawler unwatched folders"};
+    std::filesystem::create_directories(folder / "root" / "deep" / "deeper");
+
+    auto crawler = ProjectsCrawler{{
+        .roots                                    = {folder / "root"},
+        .projects_info_folder                     = folder / "Projects Info",
+        .max_folders_read_per_second              = 1'000'000,
+        .delay_between_checks_of_changes          = std::chrono::milliseconds{10},
+        .max_nb_watched_folders                   = 1, // Only the root
+        .delay_between_reads_of_unwatched_folders = std::chrono::milliseconds{100},
+    }};
+    REQUIRE(wait_for_first_crawl(crawler));
+    std::ofstream{folder / "root" / "deep" / "deeper" / "project.coollab"} << "19.0.0\n{}";
+    CHECK(wait_for_projects(crawler, 1).size() == 1);
+
+    crawler.request_stop();
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+    while (!crawler.has_stopped() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    CHECK(crawler.has_stopped());
+}
+#endif
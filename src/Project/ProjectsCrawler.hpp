@@ -0,0 +1,76 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "FilesWatcher/FilesWatcher.hpp"
+#include "projects_index.hpp"
+
+/// Finds the Coollab projects in the folders chosen by the user, so that the projects that have never been opened through the launcher show up too (e.g. the ones copied from another computer).
+/// It first walks all the folders on a few threads, and then only reads again the folders whose content changes, thanks to a FilesWatcher.
+/// Only the first folders it finds (the roots and the ones closest to them) are watched, because the system limits the number of watches. The other ones are read again every once in a while.
+/// It is throttled so that it never competes for the disk with Coollab: its threads have the lowest I/O priority, it reads a limited number of folders per second, and it pauses while a project is launching.
+class ProjectsCrawler {
+public:
+    struct Settings {
+        std::vector<std::filesystem::path> roots{};
+        std::filesystem::path              projects_info_folder{}; // Where the projects we find get registered, cf. Path::projects_info_folder()
+        unsigned int                       max_folders_read_per_second{200};
+        unsigned int                       nb_threads{2};
+        std::chrono::milliseconds          delay_between_checks_of_changes{500};
+        size_t                             max_nb_watched_folders{1000};
+        std::chrono::milliseconds          delay_between_reads_of_unwatched_folders{std::chrono::minutes{10}};
+    };
+
+    explicit ProjectsCrawler(Settings);
+    ~ProjectsCrawler();
+    ProjectsCrawler(ProjectsCrawler const&)                    = delete;
+    auto operator=(ProjectsCrawler const&) -> ProjectsCrawler& = delete;
+    ProjectsCrawler(ProjectsCrawler&&)                         = delete;
+    auto operator=(ProjectsCrawler&&) -> ProjectsCrawler&      = delete;
+
+    /// The projects that have been found and registered in the projects info folder since the last call. Doesn't touch the file system, so it is fine to call it every frame
+    auto pop_found_projects() -> std::vector<ProjectsIndexEntry>;
+    /// Stops reading the disk for a while (e.g. while Coollab is launching). The folder that is currently being read, if any, is finished first
+    void pause_for(std::chrono::milliseconds);
+    /// Once all the roots have been walked entirely. After that, we only read the folders that change
+    auto has_finished_first_crawl() const -> bool;
+    auto roots() const -> std::vector<std::filesystem::path> const& { return _settings.roots; }
+    /// Doesn't wait for the threads, which might be stuck on a slow drive. Destroy the crawler once has_stopped() returns true, so that destroying it doesn't block
+    void request_stop();
+    auto has_stopped() const -> bool;
+
+private:
+    void work();
+    /// Must be called with _mutex locked. Blocks until the throttling allows us to read another folder. Returns false if we need to stop
+    auto wait_for_turn(std::unique_lock<std::mutex>&) -> bool;
+    void read_folder(std::filesystem::path const& folder);
+    void register_project_ifn(std::filesystem::path const& file_path);
+
+private:
+    Settings                      _settings;
+    std::unique_ptr<FilesWatcher> _files_watcher{make_files_watcher()};
+
+    // Guarded by _mutex
+    std::deque<std::filesystem::path>     _folders_to_read{};
+    std::unordered_set<std::string>       _known_folders{}; // Queued or already read, so that we walk each folder only once (the changes are then handled by the _files_watcher)
+    std::unordered_set<std::string>       _watched_folders{};
+    std::unordered_set<std::string>       _unwatched_folders{}; // Over the max_nb_watched_folders, we read them again periodically instead
+    std::chrono::steady_clock::time_point _time_of_next_read_of_unwatched_folders{};
+    size_t                                _nb_folders_being_read{0};
+    bool                                  _has_finished_first_crawl{false};
+    std::vector<ProjectsIndexEntry>       _found_projects{};
+    std::chrono::steady_clock::time_point _time_of_next_read{};
+    std::chrono::steady_clock::time_point _end_of_pause{};
+    bool                                  _wants_to_stop{false};
+    size_t                                _nb_running_workers{0};
+    mutable std::mutex                    _mutex{};
+    std::condition_variable               _condition{};
+
+    std::vector<std::thread> _workers{}; // Must be declared last, so that they are started after everything else has been initialized
+};
@@ -0,0 +1,66 @@
+#include "ProjectsIdentityIndex.hpp"
+
+void ProjectsIdentityIndex::insert_or_update(std::string const& file_path, std::optional<FileIdentity> const& identity)
+{
+    remove(file_path);
+    _identity_of_path[file_path] = identity;
+    if (identity.has_value())
+        _path_of_identity[*identity] = file_path;
+}
+
+void ProjectsIdentityIndex::remove(std::string const& file_path)
+{
+    auto const it = _identity_of_path.find(file_path);
+    if (it == _identity_of_path.end())
+        return;
+    if (it->second.has_value())
+    {
+        // Two projects can have the same identity (e.g. hard links), in which case it points to only one of them
+        auto const it_path = _path_of_identity.find(*it->second);
+        if (it_path != _path_of_identity.end() && it_path->second == file_path)
+            _path_of_identity.erase(it_path);
+    }
+    _identity_of_path.erase(it);
+}
+
+auto ProjectsIdentityIndex::find(std::string const& file_path, std::optional<FileIdentity> const& identity) const -> std::optional<std::string>
+{
+    if (_identity_of_path.contains(file_path))
+        return file_path;
+    if (identity.has_value())
+    {
+        if (auto const it = _path_of_identity.find(*identity); it != _path_of_identity.end())
+            return it->second;
+    }
+    return std::nullopt;
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include "doctest/doctest.h"
+
+TEST_CASE("ProjectsIdentityIndex")
+{
+    auto index = ProjectsIdentityIndex{};
+    index.insert_or_update("/a.coollab", FileIdentity{.device = 1, .file = 10});
+    index.insert_or_update("/b.coollab", std::nullopt);
+
+    CHECK(index.find("/a.coollab", std::nullopt) == "/a.coollab");
+    CHECK(index.find("/link to a.coollab", FileIdentity{.device = 1, .file = 10}) == "/a.coollab");
+    CHECK(index.find("/other.coollab", FileIdentity{.device = 2, .file = 10}) == std::nullopt);
+    CHECK(index.find("/b.coollab", std::nullopt) == "/b.coollab");
+
+    // Renaming keeps the identity
+    index.remove("/a.coollab");
+    index.insert_or_update("/renamed.coollab", FileIdentity{.device = 1, .file = 10});
+    CHECK(!index.contains("/a.coollab"));
+    CHECK(index.find("/a.coollab", FileIdentity{.device = 1, .file = 10}) == "/renamed.coollab");
+
+    // A hard link shares its identity with another project, and removing it doesn't forget the other one
+    index.insert_or_update("/hard link.coollab", FileIdentity{.device = 1, .file = 10});
+    index.remove("/renamed.coollab");
+    CHECK(index.find("/x.coollab", FileIdentity{.device = 1, .file = 10}) == "/hard link.coollab");
+
+    index.remove("/hard link.coollab");
+    CHECK(index.find("/x.coollab", FileIdentity{.device = 1, .file = 10}) == std::nullopt);
+}
+#endif
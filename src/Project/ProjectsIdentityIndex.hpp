@@ -0,0 +1,23 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include "FileIdentity.hpp"
+
+/// Finds the project that a path refers to in O(1), either because it is the same canonical path, or because it is the same file reached through another path.
+/// Like the ProjectsSearchIndex, the projects are identified by their (canonical) file path.
+class ProjectsIdentityIndex {
+public:
+    /// `identity` is std::nullopt while we don't know it (or if the project file doesn't exist), in which case we can only find the project by its path
+    void insert_or_update(std::string const& file_path, std::optional<FileIdentity> const& identity);
+    void remove(std::string const& file_path);
+
+    /// Doesn't touch the file system: the identity of `file_path` must have been read beforehand, with file_identity()
+    /// Returns the file path of the project
+    auto find(std::string const& file_path, std::optional<FileIdentity> const& identity) const -> std::optional<std::string>;
+    auto contains(std::string const& file_path) const -> bool { return _identity_of_path.contains(file_path); }
+
+private:
+    std::unordered_map<std::string, std::optional<FileIdentity>> _identity_of_path{};
+    std::unordered_map<FileIdentity, std::string>                _path_of_identity{};
+};
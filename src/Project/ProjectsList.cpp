@@ -0,0 +1,246 @@
+#include "ProjectsList.hpp"
+#include <algorithm>
+#include <cassert>
+#include "to_lower.hpp"
+
+static auto all_orders() -> std::array<ProjectsOrder, nb_projects_orders>
+{
+    return {ProjectsOrder::MostRecent, ProjectsOrder::Name, ProjectsOrder::Version};
+}
+
+auto ProjectsList::comes_before(ProjectsOrder order, ProjectId a, ProjectId b) const -> bool
+{
+    auto const& keys_a = _slots[a].keys;
+    auto const& keys_b = _slots[b].keys;
+    switch (order)
+    {
+    case ProjectsOrder::MostRecent:
+        break;
+    case ProjectsOrder::Name:
+        if (keys_a.lower_case_name != keys_b.lower_case_name)
+            return keys_a.lower_case_name < keys_b.lower_case_name;
+        break;
+    case ProjectsOrder::Version:
+        if (keys_a.version != keys_b.version)
+        {
+            if (!keys_a.version.has_value() || !keys_b.version.has_value())
+                return keys_a.version.has_value(); // The projects without a version come last
+            return *keys_a.version > *keys_b.version;
+        }
+        break;
+    }
+    // Ties are sorted from most to least recent
+    if (keys_a.time_of_last_change != keys_b.time_of_last_change)
+        return keys_a.time_of_last_change > keys_b.time_of_last_change;
+    return a < b;
+}
+
+auto ProjectsList::new_slot(Project project) -> ProjectId
+{
+    auto id = ProjectId{};
+    if (!_free_ids.empty())
+    {
+        id = _free_ids.back();
+        _free_ids.pop_back();
+    }
+    else
+    {
+        id = static_cast<ProjectId>(_slots.size());
+        _slots.emplace_back();
+    }
+    auto& slot   = _slots[id];
+    slot.project = std::make_unique<Project>(std::move(project));
+    slot.keys    = SortKeys{
+           .time_of_last_change = slot.project->time_of_last_change(),
+           .lower_case_name     = to_lower(slot.project->name()),
+           .version             = slot.project->known_version().value_or(std::nullopt), // Never reads the project file. Until the version is known, the project is sorted as if it had none. reposition() gets called once it is known
+    };
+    return id;
+}
+
+void ProjectsList::insert_in_orders(ProjectId id)
+{
+    for (auto const order : all_orders())
+    {
+        auto& ids = _orders[static_cast<size_t>(order)];
+        ids.insert(std::upper_bound(ids.begin(), ids.end(), id, [&](ProjectId a, ProjectId b) { return comes_before(order, a, b); }), id);
+    }
+}
+
+void ProjectsList::erase_from_orders(ProjectId id)
+{
+    for (auto const order : all_orders())
+    {
+        auto&      ids = _orders[static_cast<size_t>(order)];
+        auto const it  = std::lower_bound(ids.begin(), ids.end(), id, [&](ProjectId a, ProjectId b) { return comes_before(order, a, b); });
+        assert(it != ids.end() && *it == id);
+        ids.erase(it);
+    }
+}
+
+auto ProjectsList::insert(Project project) -> ProjectId
+{
+    auto const id = new_slot(std::move(project));
+    insert_in_orders(id);
+    return id;
+}
+
+void ProjectsList::insert(std::vector<Project> projects)
+{
+    auto new_ids = std::vector<ProjectId>{};
+    new_ids.reserve(projects.size());
+    for (auto& project : projects)
+        new_ids.push_back(new_slot(std::move(project)));
+
+    for (auto const order : all_orders())
+    {
+        auto const comparator = [&](ProjectId a, ProjectId b) {
+            return comes_before(order, a, b);
+        };
+        std::sort(new_ids.begin(), new_ids.end(), comparator);
+        auto&      ids             = _orders[static_cast<size_t>(order)];
+        auto const nb_old_projects = static_cast<std::ptrdiff_t>(ids.size());
+        ids.insert(ids.end(), new_ids.begin(), new_ids.end());
+        std::inplace_merge(ids.begin(), ids.begin() + nb_old_projects, ids.end(), comparator);
+    }
+}
+
+void ProjectsList::erase(ProjectId id)
+{
+    erase_from_orders(id);
+    _slots[id] = Slot{};
+    _free_ids.push_back(id);
+}
+
+void ProjectsList::erase_if(std::function<bool(Project const&)> const& predicate)
+{
+    auto erased_ids = std::vector<ProjectId>{};
+    for (auto const id : in_order(ProjectsOrder::MostRecent))
+    {
+        if (predicate(*_slots[id].project))
+            erased_ids.push_back(id);
+    }
+    if (erased_ids.empty())
+        return;
+
+    // Erase them from the orders all at once, instead of shifting the ids once per erased project
+    for (auto const id : erased_ids)
+        _slots[id].project.reset();
+    for (auto& ids : _orders)
+        std::erase_if(ids, [&](ProjectId id) { return _slots[id].project == nullptr; });
+    for (auto const id : erased_ids)
+    {
+        _slots[id] = Slot{};
+        _free_ids.push_back(id);
+    }
+}
+
+void ProjectsList::clear()
+{
+    _slots.clear();
+    _free_ids.clear();
+    for (auto& ids : _orders)
+        ids.clear();
+}
+
+void ProjectsList::reposition(ProjectId id)
+{
+    erase_from_orders(id); // Uses the old keys to find the project
+    auto& slot = _slots[id];
+    slot.keys  = SortKeys{
+         .time_of_last_change = slot.project->time_of_last_change(),
+         .lower_case_name     = to_lower(slot.project->name()),
+         .version             = slot.project->known_version().value_or(std::nullopt),
+    };
+    insert_in_orders(id);
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+static auto make_project(std::string const& name, int64_t time, std::optional<std::string> const& version) -> Project
+{
+    return Project{ProjectsIndexEntry{
+        .file_path           = fmt::format("/projects/{}.coollab", name),
+        .time_of_last_change = time,
+        .time_of_version     = 0,
+        .version             = version ? VersionName::from(*version) : std::nullopt,
+    }};
+}
+
+static auto names_in_order(ProjectsList const& list, ProjectsOrder order) -> std::vector<std::string>
+{
+    auto res = std::vector<std::string>{};
+    for (auto const id : list.in_order(order))
+        res.push_back(list[id].name());
+    return res;
+}
+
+TEST_CASE("ProjectsList keeps the projects sorted in all the orders")
+{
+    auto       list = ProjectsList{};
+    auto const b    = list.insert(make_project("b", 2, "19.0.0"));
+    auto const c    = list.insert(make_project("C", 3, std::nullopt));
+    list.insert(std::vector<Project>{make_project("a", 1, "19.1.0"), make_project("d", 4, "18.0.0")});
+
+    CHECK(names_in_order(list, ProjectsOrder::MostRecent) == std::vector<std::string>{"d", "C", "b", "a"});
+    CHECK(names_in_order(list, ProjectsOrder::Name) == std::vector<std::string>{"a", "b", "C", "d"});
+    CHECK(names_in_order(list, ProjectsOrder::Version) == std::vector<std::string>{"a", "b", "d", "C"});
+
+    SUBCASE("Ids stay valid")
+    {
+        CHECK(list[b].name() == "b");
+        CHECK(list[c].name() == "C");
+    }
+    SUBCASE("Erasing")
+    {
+        list.erase(c);
+        CHECK(names_in_order(list, ProjectsOrder::MostRecent) == std::vector<std::string>{"d", "b", "a"});
+        list.erase_if([](Project const& project) { return project.name() == "d"; });
+        CHECK(names_in_order(list, ProjectsOrder::Version) == std::vector<std::string>{"a", "b"});
+        CHECK(list[b].name() == "b");
+        auto const e = list.insert(make_project("e", 0, "17.0.0")); // Reuses a free id
+        CHECK(list[e].name() == "e");
+        CHECK(names_in_order(list, ProjectsOrder::MostRecent) == std::vector<std::string>{"b", "a", "e"});
+    }
+    SUBCASE("Repositioning after a rename")
+    {
+        list[b].set_file_path("/projects/z.coollab");
+        list.reposition(b);
+        CHECK(names_in_order(list, ProjectsOrder::Name) == std::vector<std::string>{"a", "C", "d", "z"});
+        CHECK(list[b].name() == "z");
+    }
+    SUBCASE("Iterating goes from most to least recent")
+    {
+        auto names = std::vector<std::string>{};
+        for (auto const& project : list)
+            names.push_back(project.name());
+        CHECK(names == std::vector<std::string>{"d", "C", "b", "a"});
+    }
+}
+
+TEST_CASE("Benchmark: inserting projects one by one in a list of 10k" * doctest::skip()) // Run with --no-skip
+{
+    auto projects = std::vector<Project>{};
+    for (int i = 0; i < 10'000; ++i)
+        projects.push_back(make_project(fmt::format("project {}", i), (i * 7919) % 10'000, fmt::format("19.{}.0", i % 7)));
+    auto list = ProjectsList{};
+    list.insert(projects);
+    auto vector = projects;
+    std::sort(vector.begin(), vector.end(), [](Project const& a, Project const& b) {
+        return a.time_of_last_change() > b.time_of_last_change();
+    });
+
+    static constexpr int nb_iterations{1000};
+    // What we used to do: insert a Project at the beginning of a std::vector<Project>, which moves all the other Projects
+    auto const duration_vector = average_duration_of(nb_iterations, [&](int i) {
+        vector.insert(vector.begin(), make_project(fmt::format("new project {}", i), 20'000 + i, "19.0.0"));
+    });
+    auto const duration_list = average_duration_of(nb_iterations, [&](int i) {
+        list.insert(make_project(fmt::format("new project {}", i), 20'000 + i, "19.0.0"));
+    });
+
+    MESSAGE(fmt::format("Inserting a project in a list of 10k, in all the orders at once: {}us. In a std::vector<Project>, in a single order: {}us", duration_list.count(), duration_vector.count()));
+}
+#endif
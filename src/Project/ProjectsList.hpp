@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <functional>
+#include <memory>
+#include "Project.hpp"
+
+/// Stays valid as long as the project is in the list, whatever gets inserted, removed or reordered
+using ProjectId = uint32_t;
+
+enum class ProjectsOrder {
+    MostRecent, // Most recently changed first
+    Name,       // Alphabetical
+    Version,    // Newest version first
+};
+inline constexpr size_t nb_projects_orders{3};
+
+/// Keeps the projects sorted in all the orders at once, so that switching between them is free, and inserting / removing / updating a project only moves ids around instead of whole Projects.
+/// The keys used for sorting are computed once per project (and again when reposition() is called), so that sorting never touches the file system.
+class ProjectsList {
+public:
+    auto insert(Project project) -> ProjectId;
+    /// Cheaper than inserting them one by one: they get sorted together and then merged with the existing ones
+    void insert(std::vector<Project> projects);
+    void erase(ProjectId);
+    void erase_if(std::function<bool(Project const&)> const& predicate);
+    void clear();
+    /// Must be called after changing anything the project is sorted by (its path, its version or its time of last change)
+    void reposition(ProjectId);
+
+    auto operator[](ProjectId id) -> Project& { return *_slots[id].project; }
+    auto operator[](ProjectId id) const -> Project const& { return *_slots[id].project; }
+    auto size() const -> size_t { return in_order(ProjectsOrder::MostRecent).size(); }
+    auto in_order(ProjectsOrder order) const -> std::vector<ProjectId> const& { return _orders[static_cast<size_t>(order)]; }
+
+    /// Iterates from the most to the least recently changed project
+    template<typename ProjectT, typename ListT>
+    class Iterator {
+    public:
+        Iterator(ListT& list, std::vector<ProjectId>::const_iterator it)
+            : _list{&list}
+            , _it{it}
+        {}
+        auto operator*() const -> ProjectT& { return (*_list)[*_it]; }
+        auto operator++() -> Iterator&
+        {
+            ++_it;
+            return *this;
+        }
+        auto operator!=(Iterator const& other) const -> bool { return _it != other._it; }
+
+    private:
+        ListT*                                 _list;
+        std::vector<ProjectId>::const_iterator _it;
+    };
+    auto begin() { return Iterator<Project, ProjectsList>{*this, in_order(ProjectsOrder::MostRecent).begin()}; }
+    auto end() { return Iterator<Project, ProjectsList>{*this, in_order(ProjectsOrder::MostRecent).end()}; }
+    auto begin() const { return Iterator<Project const, ProjectsList const>{*this, in_order(ProjectsOrder::MostRecent).begin()}; }
+    auto end() const { return Iterator<Project const, ProjectsList const>{*this, in_order(ProjectsOrder::MostRecent).end()}; }
+
+private:
+    struct SortKeys {
+        std::filesystem::file_time_type time_of_last_change{};
+        std::string                     lower_case_name{};
+        std::optional<VersionName>      version{};
+    };
+    struct Slot {
+        std::unique_ptr<Project> project{}; // nullptr when the slot is free. Behind a pointer so that growing _slots doesn't move the Projects
+        SortKeys                 keys{};
+    };
+
+    auto new_slot(Project project) -> ProjectId;
+    /// Strict total order (the ids break the ties), so that we can find a project with a binary search
+    auto comes_before(ProjectsOrder, ProjectId a, ProjectId b) const -> bool;
+    void insert_in_orders(ProjectId);
+    void erase_from_orders(ProjectId);
+
+private:
+    std::vector<Slot>                                     _slots{};
+    std::vector<ProjectId>                                _free_ids{};
+    std::array<std::vector<ProjectId>, nb_projects_orders> _orders{};
+};
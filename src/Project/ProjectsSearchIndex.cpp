@@ -0,0 +1,367 @@
+#include "ProjectsSearchIndex.hpp"
+#include <algorithm>
+#include <optional>
+#include "to_lower.hpp"
+
+static auto trigram(std::string_view str, size_t i) -> uint32_t
+{
+    return static_cast<uint32_t>(static_cast<unsigned char>(str[i])) << 16
+           | static_cast<uint32_t>(static_cast<unsigned char>(str[i + 1])) << 8
+           | static_cast<uint32_t>(static_cast<unsigned char>(str[i + 2]));
+}
+
+static auto is_start_of_word(std::string_view str, size_t position) -> bool
+{
+    if (position == 0)
+        return true;
+    auto const previous = static_cast<unsigned char>(str[position - 1]);
+    return !std::isalnum(previous) && previous < 128; // Bytes >= 128 are part of a UTF-8 character, which we consider to be a letter
+}
+
+/// The first one and two letters of each word are indexed too, so that short queries don't have to go through all the projects.
+/// They can't collide with the trigrams, which only use the lower 24 bits.
+static auto start_of_word(std::string_view str, size_t i, size_t length) -> uint32_t
+{
+    return length == 1
+               ? 1u << 24 | static_cast<uint32_t>(static_cast<unsigned char>(str[i]))
+               : 2u << 24 | static_cast<uint32_t>(static_cast<unsigned char>(str[i])) << 8 | static_cast<uint32_t>(static_cast<unsigned char>(str[i + 1]));
+}
+
+static auto sorted_and_deduplicated(std::vector<uint32_t> keys) -> std::vector<uint32_t>
+{
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+/// All the trigrams and starts of words
+static auto keys_of_document(std::initializer_list<std::string_view> strings) -> std::vector<uint32_t>
+{
+    auto res = std::vector<uint32_t>{};
+    for (auto const str : strings)
+    {
+        for (size_t i = 0; i < str.size(); ++i)
+        {
+            if (i + 3 <= str.size())
+                res.push_back(trigram(str, i));
+            if (is_start_of_word(str, i))
+            {
+                res.push_back(start_of_word(str, i, 1));
+                if (i + 2 <= str.size())
+                    res.push_back(start_of_word(str, i, 2));
+            }
+        }
+    }
+    return sorted_and_deduplicated(std::move(res));
+}
+
+/// The trigrams of the word, or its start if it is too short to have any
+static auto keys_of_query_word(std::string_view word) -> std::vector<uint32_t>
+{
+    if (word.size() < 3)
+        return {start_of_word(word, 0, word.size())};
+    auto res = std::vector<uint32_t>{};
+    for (size_t i = 0; i + 3 <= word.size(); ++i)
+        res.push_back(trigram(word, i));
+    return sorted_and_deduplicated(std::move(res));
+}
+
+void ProjectsSearchIndex::insert_or_update(std::string const& key, std::string_view name, std::string_view path, std::string_view version)
+{
+    auto id = uint32_t{};
+    if (auto const it = _document_of_key.find(key); it != _document_of_key.end())
+    {
+        id = it->second;
+        remove_from_postings(id);
+    }
+    else if (!_free_document_ids.empty())
+    {
+        id = _free_document_ids.back();
+        _free_document_ids.pop_back();
+        _document_of_key[key] = id;
+    }
+    else
+    {
+        id = static_cast<uint32_t>(_documents.size());
+        _documents.emplace_back();
+        _document_of_key[key] = id;
+    }
+
+    _documents[id] = Document{
+        .key     = key,
+        .name    = to_lower(name),
+        .path    = to_lower(path),
+        .version = to_lower(version),
+    };
+    auto const& document = _documents[id];
+    for (auto const key : keys_of_document({document.name, document.path, document.version}))
+    {
+        auto& posting = _postings[key];
+        if (posting.empty() || posting.back() < id)
+            posting.push_back(id); // Usual case, when we are not reusing the id of a removed document
+        else
+            posting.insert(std::lower_bound(posting.begin(), posting.end(), id), id);
+    }
+}
+
+void ProjectsSearchIndex::remove(std::string const& key)
+{
+    auto const it = _document_of_key.find(key);
+    if (it == _document_of_key.end())
+        return;
+    remove_from_postings(it->second);
+    _documents[it->second] = Document{};
+    _free_document_ids.push_back(it->second);
+    _document_of_key.erase(it);
+}
+
+void ProjectsSearchIndex::remove_from_postings(uint32_t document_id)
+{
+    auto const& document = _documents[document_id];
+    for (auto const key : keys_of_document({document.name, document.path, document.version}))
+    {
+        auto const it = _postings.find(key);
+        if (it == _postings.end())
+            continue;
+        auto& posting  = it->second;
+        auto  position = std::lower_bound(posting.begin(), posting.end(), document_id);
+        if (position != posting.end() && *position == document_id)
+            posting.erase(position);
+        if (posting.empty())
+            _postings.erase(it);
+    }
+}
+
+/// Tolerate a few typos in long words (one typo breaks up to 3 trigrams), but not in short ones, where they would match way too many things
+static auto min_nb_trigrams_to_match(size_t nb_trigrams) -> size_t
+{
+    return nb_trigrams < 3 ? nb_trigrams : (nb_trigrams + 1) / 2;
+}
+
+/// 0 if `word` is not in `str`
+static auto score_of_exact_match(std::string_view word, std::string_view str, int score_if_found) -> int
+{
+    // Prefer the matches at the start of a word, e.g. "sun" in "my sunset" over "tsunami"
+    bool found{false};
+    for (auto position = str.find(word); position != std::string_view::npos; position = str.find(word, position + 1))
+    {
+        if (is_start_of_word(str, position))
+            return score_if_found + score_if_found / 2;
+        found = true;
+    }
+    // Very short words are only matched at the start of a word, otherwise they would match almost everything
+    return found && word.size() >= 3 ? score_if_found : 0;
+}
+
+static auto score_of_word(std::string_view word, std::string_view name, std::string_view path, std::string_view version) -> int
+{
+    if (int const score = score_of_exact_match(word, name, 100))
+        return score;
+    if (int const score = score_of_exact_match(word, version, 60))
+        return score;
+    if (int const score = score_of_exact_match(word, path, 30))
+        return score;
+
+    // Fuzzy match
+    size_t nb_found{0};
+    size_t nb_found_in_name{0};
+    for (size_t i = 0; i + 3 <= word.size(); ++i)
+    {
+        auto const tri = word.substr(i, 3);
+        if (name.find(tri) != std::string_view::npos)
+            ++nb_found_in_name;
+        else if (path.find(tri) == std::string_view::npos && version.find(tri) == std::string_view::npos)
+            continue;
+        ++nb_found;
+    }
+    size_t const nb_trigrams = word.size() < 3 ? 0 : word.size() - 2;
+    if (nb_trigrams < 3 || nb_found < min_nb_trigrams_to_match(nb_trigrams))
+        return 0;
+    return static_cast<int>(20 * (nb_found + nb_found_in_name) / (2 * nb_trigrams)) + 1; // Always lower than an exact match
+}
+
+auto ProjectsSearchIndex::search(std::string_view query) const -> std::vector<Match>
+{
+    auto const lower_case_query = to_lower(query);
+    auto       words            = std::vector<std::string_view>{};
+    for (size_t begin = 0; begin < lower_case_query.size();)
+    {
+        auto end = lower_case_query.find(' ', begin);
+        if (end == std::string::npos)
+            end = lower_case_query.size();
+        if (end > begin)
+            words.push_back(std::string_view{lower_case_query}.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    if (words.empty())
+        return {};
+
+    // For each word, count how many of its keys each document contains. This only goes through the documents that contain at least one of them
+    auto candidates    = std::optional<std::vector<uint32_t>>{}; // std::nullopt means all the documents
+    auto nb_keys_found = std::vector<uint16_t>{};
+    for (auto const word : words)
+    {
+        auto const keys = keys_of_query_word(word);
+        nb_keys_found.assign(_documents.size(), 0);
+        for (auto const key : keys)
+        {
+            auto const it = _postings.find(key);
+            if (it == _postings.end())
+                continue;
+            for (auto const id : it->second)
+                ++nb_keys_found[id];
+        }
+        auto const is_candidate = [&](uint32_t id) {
+            return nb_keys_found[id] >= min_nb_trigrams_to_match(keys.size());
+        };
+        auto new_candidates = std::vector<uint32_t>{};
+        if (candidates.has_value())
+        {
+            std::copy_if(candidates->begin(), candidates->end(), std::back_inserter(new_candidates), is_candidate);
+        }
+        else
+        {
+            for (uint32_t id = 0; id < _documents.size(); ++id)
+            {
+                if (is_candidate(id))
+                    new_candidates.push_back(id);
+            }
+        }
+        candidates = std::move(new_candidates);
+    }
+
+    auto res = std::vector<Match>{};
+    for (auto const id : candidates.value_or(std::vector<uint32_t>{}))
+    {
+        auto const& document = _documents[id];
+        int         score{0};
+        for (auto const word : words)
+        {
+            int const word_score = score_of_word(word, document.name, document.path, document.version);
+            if (word_score == 0)
+            {
+                score = 0;
+                break;
+            }
+            score += word_score;
+        }
+        if (score == 0)
+            continue;
+        if (document.name == lower_case_query)
+            score += 1000;
+        res.push_back(Match{.key = document.key, .score = score});
+    }
+    std::stable_sort(res.begin(), res.end(), [](Match const& a, Match const& b) {
+        return a.score > b.score;
+    });
+    return res;
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include <random>
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+static auto keys_of(std::vector<ProjectsSearchIndex::Match> const& matches) -> std::vector<std::string>
+{
+    auto res = std::vector<std::string>{};
+    for (auto const& match : matches)
+        res.emplace_back(match.key);
+    return res;
+}
+
+TEST_CASE("Searching projects")
+{
+    auto index = ProjectsSearchIndex{};
+    index.insert_or_update("a", "Sunset", "/home/projects/Sunset.coollab", "19.0.3");
+    index.insert_or_update("b", "Tsunami", "/home/projects/Tsunami.coollab", "18.0.0");
+    index.insert_or_update("c", "Fractal", "/home/sun/Fractal.coollab", "19.1.0");
+
+    SUBCASE("Matches in the name rank higher than matches in the path, and the start of a word ranks higher than the middle")
+    {
+        CHECK(keys_of(index.search("sun")) == std::vector<std::string>{"a", "b", "c"});
+    }
+    SUBCASE("Case doesn't matter")
+    {
+        CHECK(keys_of(index.search("FRACTAL")) == std::vector<std::string>{"c"});
+    }
+    SUBCASE("All the words must match")
+    {
+        CHECK(keys_of(index.search("sun 19.1")) == std::vector<std::string>{"c"});
+        CHECK(keys_of(index.search("sun 18")) == std::vector<std::string>{"b"});
+        CHECK(index.search("sun nothing").empty());
+    }
+    SUBCASE("Typos are tolerated")
+    {
+        CHECK(keys_of(index.search("fractol")) == std::vector<std::string>{"c"});
+    }
+    SUBCASE("Short queries")
+    {
+        CHECK(keys_of(index.search("ts")) == std::vector<std::string>{"b"}); // Not "projects", because short words only match the start of a word
+        CHECK(keys_of(index.search("f 19")) == std::vector<std::string>{"c"});
+        CHECK(index.search("").empty());
+        CHECK(index.search("   ").empty());
+    }
+    SUBCASE("Updating and removing")
+    {
+        index.insert_or_update("c", "Mandelbrot", "/home/sun/Mandelbrot.coollab", "19.1.0");
+        CHECK(index.search("fractal").empty());
+        CHECK(keys_of(index.search("mandel")) == std::vector<std::string>{"c"});
+        index.remove("a");
+        CHECK(keys_of(index.search("sunset")).empty());
+        CHECK(index.size() == 2);
+        index.insert_or_update("d", "Sunrise", "/home/projects/Sunrise.coollab", "19.0.3"); // Reuses the id of "a"
+        CHECK(keys_of(index.search("sunrise")) == std::vector<std::string>{"d"});
+        CHECK(keys_of(index.search("19.0.3")) == std::vector<std::string>{"d"});
+    }
+}
+
+TEST_CASE("Benchmark: searching 10k projects" * doctest::skip()) // Run with --no-skip
+{
+    auto const syllables = std::vector<std::string>{"sun", "ka", "lo", "fra", "ctal", "mi", "ra", "ge", "no", "va", "tri", "an", "gle", "wa", "ve"};
+    auto       rng       = std::mt19937{42};
+    auto       names     = std::vector<std::string>{};
+    for (int i = 0; i < 10'000; ++i)
+    {
+        auto name = std::string{};
+        for (size_t j = 0; j < 2 + rng() % 3; ++j)
+            name += syllables[rng() % syllables.size()];
+        names.push_back(fmt::format("{} {}", name, i));
+    }
+    auto const path_of    = [](std::string const& name) { return fmt::format("/home/user/Documents/Coollab Projects/{}.coollab", name); };
+    auto const version_of = [](size_t i) { return fmt::format("19.{}.{}", i % 3, i % 5); };
+
+    auto       index             = ProjectsSearchIndex{};
+    auto const duration_indexing = duration_of([&]() {
+        for (size_t i = 0; i < names.size(); ++i)
+            index.insert_or_update(path_of(names[i]), names[i], path_of(names[i]), version_of(i));
+    });
+
+    // What we would do without an index: go through all the projects, and check if their name contains the query
+    auto const linear_search = [&](std::string const& query) {
+        auto res = std::vector<size_t>{};
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            auto const lower_case_name = to_lower(names[i]);
+            if (lower_case_name.find(query) != std::string::npos || to_lower(path_of(names[i])).find(query) != std::string::npos)
+                res.push_back(i);
+        }
+        return res;
+    };
+
+    MESSAGE(fmt::format("Indexing {} projects: {}ms", names.size(), duration_indexing.count()));
+    for (std::string const query : {"s", "sun", "fractal", "fractol", "sunka 123", "19.1", "nothing"})
+    {
+        static constexpr int nb_iterations{100};
+        size_t               nb_results{0};
+        auto const           duration_index = average_duration_of(nb_iterations, [&](int) {
+            nb_results = index.search(query).size();
+        });
+        auto const duration_linear = average_duration_of(nb_iterations, [&](int) {
+            linear_search(query);
+        });
+
+        MESSAGE(fmt::format("\"{}\": {} results in {}us (linear search: {}us)", query, nb_results, duration_index.count(), duration_linear.count()));
+    }
+}
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// Trigram index over the name, path and version of the projects, so that searching doesn't have to go through all the projects.
+/// It is updated incrementally: adding, renaming or removing a project only touches the trigrams of that project.
+/// The starts of words are indexed too, for the queries that are too short to have trigrams.
+/// The projects are identified by a key (their file path), because their position in the ProjectManager's list changes all the time.
+class ProjectsSearchIndex {
+public:
+    struct Match {
+        std::string_view key; // Only valid until the next modification of the index
+        int              score;
+    };
+
+    /// Also used to update a project whose name, path or version has changed
+    void insert_or_update(std::string const& key, std::string_view name, std::string_view path, std::string_view version);
+    void remove(std::string const& key);
+
+    /// The query is split into words, and all of them must be found (case-insensitive) in the name, path or version of the project, with a bit of tolerance for typos.
+    /// The results are sorted from best to worst match (a match in the name ranks higher than one in the path, a match at the start of a word ranks higher than one in the middle, etc.)
+    auto search(std::string_view query) const -> std::vector<Match>;
+
+    auto size() const -> size_t { return _document_of_key.size(); }
+
+private:
+    using Key = uint32_t; // Either a trigram or the start of a word
+    struct Document {
+        std::string key{};
+        std::string name{};    // Lowercase
+        std::string path{};    // Lowercase
+        std::string version{}; // Lowercase
+    };
+
+    void remove_from_postings(uint32_t document_id);
+
+private:
+    std::vector<Document>                              _documents{};         // Indexed by document id
+    std::vector<uint32_t>                              _free_document_ids{}; // Ids of removed documents, reused by the next insertions
+    std::unordered_map<std::string, uint32_t>          _document_of_key{};
+    std::unordered_map<Key, std::vector<uint32_t>>     _postings{}; // For each key, the sorted ids of the documents that contain it
+};
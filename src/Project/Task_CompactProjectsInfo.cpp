@@ -0,0 +1,287 @@
+#include "Task_CompactProjectsInfo.hpp"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <unordered_map>
+#include "Cool/File/File.h"
+#include "Cool/Log/Log.hpp"
+#include "Cool/Utils/hash_project_path_for_info_folder.hpp"
+#include "FileIdentity.hpp"
+#include "Path.hpp"
+
+static constexpr auto min_age                    = std::chrono::hours{1};       // A project might be being created, copied or renamed right now
+static constexpr auto min_age_to_ask_for_consent = std::chrono::hours{24 * 30}; // Don't bother the user about a drive that has just been disconnected, or a project they are about to relink
+static constexpr auto duration_in_archive        = std::chrono::hours{24 * 90}; // Enough time to recover a project info folder by hand if we were wrong
+
+struct InfoFolder {
+    std::filesystem::path           folder{};
+    std::filesystem::path           file_path{};
+    std::filesystem::file_time_type time_of_last_change{}; // Of its path.txt
+};
+
+static auto archive(std::filesystem::path const& info_folder, std::filesystem::path const& archive_folder, std::filesystem::file_time_type now) -> bool
+{
+    auto error_code = std::error_code{};
+    std::filesystem::create_directories(archive_folder, error_code);
+    auto destination = archive_folder / info_folder.filename();
+    for (int i = 1; std::filesystem::exists(destination, error_code); ++i)
+        destination = archive_folder / fmt::format("{} ({})", info_folder.filename().string(), i);
+    std::filesystem::rename(info_folder, destination, error_code);
+    if (error_code)
+    {
+        Cool::Log::internal_warning("Compact projects info", fmt::format("Failed to archive \"{}\": {}", info_folder.string(), error_code.message()));
+        return false;
+    }
+    std::filesystem::last_write_time(destination, now, error_code); // So that we know when to delete it for good
+    return true;
+}
+
+/// Moves the files that `into` doesn't have yet (e.g. the thumbnail), and keeps the most recent time of last change
+static void merge_into(InfoFolder const& from, InfoFolder& into)
+{
+    auto error_code = std::error_code{};
+    for (auto const& entry : std::filesystem::directory_iterator{from.folder, error_code})
+    {
+        auto const destination = into.folder / entry.path().filename();
+        if (!std::filesystem::exists(destination, error_code))
+            std::filesystem::rename(entry.path(), destination, error_code);
+    }
+    if (from.time_of_last_change > into.time_of_last_change)
+    {
+        std::filesystem::last_write_time(into.folder / "path.txt", from.time_of_last_change, error_code);
+        into.time_of_last_change = from.time_of_last_change;
+    }
+}
+
+auto compact_projects_info_folder(
+    std::filesystem::path const&    projects_info_folder,
+    std::filesystem::path const&    archive_folder,
+    std::filesystem::file_time_type now,
+    std::atomic<bool> const&        cancel
+) -> ProjectsInfoCompaction
+{
+    auto res        = ProjectsInfoCompaction{};
+    auto error_code = std::error_code{};
+
+    // List everything first, because we are going to move folders out of it
+    auto info_folders = std::vector<std::filesystem::path>{};
+    for (auto const& entry : std::filesystem::directory_iterator{projects_info_folder, error_code})
+        info_folders.push_back(entry.path());
+
+    // Group the info folders by the project they point to
+    auto folders_of_project = std::map<std::string, std::vector<InfoFolder>>{};
+    for (auto const& folder : info_folders)
+    {
+        if (cancel.load())
+            return res;
+        auto const time_of_last_change = std::filesystem::last_write_time(folder / "path.txt", error_code);
+        auto const is_broken           = static_cast<bool>(error_code); // Its creation failed halfway. It never shows up in the list, but the scan reads it on every startup
+        if (now - (is_broken ? std::filesystem::last_write_time(folder, error_code) : time_of_last_change) < min_age)
+            continue;
+
+        auto path = std::string{};
+        if (!is_broken)
+        {
+            auto file = std::ifstream{folder / "path.txt"};
+            std::getline(file, path);
+        }
+        if (path.empty())
+        {
+            archive(folder, archive_folder, now);
+            continue;
+        }
+        auto const file_path = Cool::File::weakly_canonical(path); // Same as what the scan does
+        folders_of_project[file_path.string()].push_back({.folder = folder, .file_path = file_path, .time_of_last_change = time_of_last_change});
+    }
+
+    // Only keep the folder that the Project will look for, i.e. the one named after the hash of its path
+    auto projects = std::vector<InfoFolder>{};
+    projects.reserve(folders_of_project.size());
+    for (auto& [_, folders] : folders_of_project)
+    {
+        auto const expected_folder = projects_info_folder / Cool::hash_project_path_for_info_folder(folders[0].file_path);
+        std::sort(folders.begin(), folders.end(), [](InfoFolder const& a, InfoFolder const& b) {
+            return a.time_of_last_change > b.time_of_last_change;
+        });
+        auto const it   = std::find_if(folders.begin(), folders.end(), [&](InfoFolder const& info) { return info.folder == expected_folder; });
+        auto       kept = it != folders.end() ? *it : folders[0];
+        for (auto const& info : folders)
+        {
+            if (info.folder == kept.folder)
+                continue;
+            merge_into(info, kept);
+            archive(info.folder, archive_folder, now);
+        }
+        if (kept.folder != expected_folder)
+        {
+            std::filesystem::rename(kept.folder, expected_folder, error_code);
+            if (!error_code)
+                kept.folder = expected_folder;
+        }
+        if (folders.size() > 1)
+            res.projects_with_merged_duplicates.push_back(kept.file_path);
+        projects.push_back(std::move(kept));
+    }
+
+    auto project_of_identity = std::unordered_map<FileIdentity, InfoFolder*>{};
+    for (auto& project : projects)
+    {
+        if (cancel.load())
+            return res;
+        if (auto const identity = file_identity(project.file_path))
+        {
+            auto const [it, is_new] = project_of_identity.try_emplace(*identity, &project);
+            if (is_new)
+                continue;
+            // The same file, reached through two different paths (symlink, hard link, bind mount, etc.). Keep the one that has been used most recently
+            auto&      other        = *it->second;
+            bool const keep_project = project.time_of_last_change > other.time_of_last_change;
+            auto&      kept         = keep_project ? project : other;
+            auto&      removed      = keep_project ? other : project;
+            merge_into(removed, kept);
+            if (archive(removed.folder, archive_folder, now))
+                res.removed_projects.push_back(removed.file_path);
+            it->second = &kept;
+        }
+        else if (now - project.time_of_last_change > min_age_to_ask_for_consent)
+        {
+            // Even if its folder is still there, we can't tell that it has been deleted: it might have been moved or renamed, and the user can relink it with "Find project file". And an empty mount point always exists
+            res.missing_projects.push_back({.file_path = project.file_path, .info_folder_path = project.folder});
+        }
+    }
+
+    for (auto const& entry : std::filesystem::directory_iterator{archive_folder, error_code})
+    {
+        if (now - std::filesystem::last_write_time(entry.path(), error_code) > duration_in_archive)
+            std::filesystem::remove_all(entry.path(), error_code);
+    }
+
+    return res;
+}
+
+void Task_CompactProjectsInfo::execute()
+{
+    auto compaction = compact_projects_info_folder(Path::projects_info_folder(), Path::projects_info_archive_folder(), std::filesystem::file_time_type::clock::now(), _cancel);
+    std::unique_lock lock{_incoming_compaction->mutex};
+    _incoming_compaction->compaction = std::move(compaction);
+}
+
+void Task_ArchiveProjectsInfo::execute()
+{
+    auto const now              = std::filesystem::file_time_type::clock::now();
+    auto       removed_projects = std::vector<std::filesystem::path>{};
+    for (auto const& project : _projects)
+    {
+        if (archive(project.info_folder_path, Path::projects_info_archive_folder(), now))
+            removed_projects.push_back(project.file_path);
+    }
+    std::unique_lock lock{_incoming_compaction->mutex};
+    std::move(removed_projects.begin(), removed_projects.end(), std::back_inserter(_incoming_compaction->archived_projects));
+}
+
+void Task_DeleteDuplicateProjectsInfo::execute()
+{
+    for (auto const& info_folder : _info_folders)
+    {
+        auto error_code = std::error_code{};
+        std::filesystem::remove_all(info_folder, error_code);
+    }
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+TEST_CASE("Compacting the projects info folder")
+{
+    auto const folder         = TemporaryFolder{"Compact projects info"};
+    auto const info_folder    = folder / "Projects Info";
+    auto const archive_folder = folder / "Projects Info Archive";
+    auto const projects       = folder / "Projects";
+    std::filesystem::create_directories(projects);
+    std::filesystem::create_directories(archive_folder);
+
+    auto const now             = std::filesystem::file_time_type::clock::now();
+    auto const long_ago        = now - std::chrono::hours{24 * 365};
+    auto const yesterday       = now - std::chrono::hours{24};
+    auto const add_info_folder = [&](std::string const& name, std::optional<std::filesystem::path> const& file_path, std::filesystem::file_time_type time) {
+        std::filesystem::create_directories(info_folder / name);
+        if (file_path.has_value())
+        {
+            std::ofstream{info_folder / name / "path.txt"} << file_path->string();
+            std::filesystem::last_write_time(info_folder / name / "path.txt", time);
+        }
+        std::filesystem::last_write_time(info_folder / name, time);
+    };
+    auto const add_project = [&](std::string const& name, std::filesystem::file_time_type time) {
+        auto const file_path = Cool::File::weakly_canonical(projects / name);
+        std::ofstream{file_path} << "19.0.0\n{}";
+        add_info_folder(Cool::hash_project_path_for_info_folder(file_path), file_path, time);
+        return file_path;
+    };
+    auto const archived = [&](std::filesystem::path const& info) {
+        return !std::filesystem::exists(info) && std::filesystem::exists(archive_folder / info.filename());
+    };
+    auto const info_of = [&](std::filesystem::path const& file_path) {
+        return info_folder / Cool::hash_project_path_for_info_folder(file_path);
+    };
+
+    auto const healthy = add_project("healthy.coollab", long_ago);
+    add_info_folder("broken", std::nullopt, long_ago);
+    add_info_folder("broken but recent", std::nullopt, now);
+
+    // Two folders for the same project, the misnamed one is more recent and has the thumbnail
+    auto const duplicated = add_project("duplicated.coollab", long_ago);
+    add_info_folder("misnamed", duplicated, yesterday);
+    std::ofstream{info_folder / "misnamed" / "thumbnail.png"} << "png";
+
+    // The same file through a hard link: the most recently used one is kept
+    auto const original = add_project("original.coollab", yesterday);
+    std::filesystem::create_hard_link(original, projects / "hard link.coollab");
+    auto const hard_link = Cool::File::weakly_canonical(projects / "hard link.coollab");
+    add_info_folder(Cool::hash_project_path_for_info_folder(hard_link), hard_link, long_ago);
+
+    auto const deleted = add_project("deleted.coollab", long_ago);
+    std::filesystem::remove(deleted);
+    auto const recently_deleted = add_project("recently deleted.coollab", yesterday);
+    std::filesystem::remove(recently_deleted);
+    auto const on_missing_drive        = std::filesystem::path{"/missing drive/project.coollab"};
+    auto const recent_on_missing_drive = std::filesystem::path{"/missing drive/recent project.coollab"};
+    add_info_folder(Cool::hash_project_path_for_info_folder(on_missing_drive), on_missing_drive, long_ago);
+    add_info_folder(Cool::hash_project_path_for_info_folder(recent_on_missing_drive), recent_on_missing_drive, yesterday);
+
+    std::filesystem::create_directories(archive_folder / "archived long ago");
+    std::filesystem::last_write_time(archive_folder / "archived long ago", long_ago);
+
+    auto const cancel     = std::atomic<bool>{false};
+    auto const compaction = compact_projects_info_folder(info_folder, archive_folder, now, cancel);
+
+    CHECK(std::filesystem::exists(info_of(healthy)));
+    CHECK(archived(info_folder / "broken"));
+    CHECK(std::filesystem::exists(info_folder / "broken but recent"));
+
+    CHECK(compaction.projects_with_merged_duplicates == std::vector<std::filesystem::path>{duplicated});
+    CHECK(archived(info_folder / "misnamed"));
+    CHECK(std::filesystem::exists(info_of(duplicated) / "thumbnail.png"));
+    CHECK(std::filesystem::last_write_time(info_of(duplicated) / "path.txt") == yesterday);
+
+    CHECK(std::filesystem::exists(info_of(original)));
+    CHECK(archived(info_of(hard_link)));
+    CHECK(compaction.removed_projects == std::vector<std::filesystem::path>{hard_link});
+
+    // We need the user's consent for these ones (they might have been moved or renamed), and we don't even ask for the ones that have been used recently
+    auto missing_projects = std::vector<std::filesystem::path>{};
+    for (auto const& project : compaction.missing_projects)
+        missing_projects.push_back(project.file_path);
+    std::sort(missing_projects.begin(), missing_projects.end());
+    auto expected_missing_projects = std::vector<std::filesystem::path>{deleted, on_missing_drive};
+    std::sort(expected_missing_projects.begin(), expected_missing_projects.end());
+    CHECK(missing_projects == expected_missing_projects);
+    CHECK(std::filesystem::exists(info_of(deleted)));
+    CHECK(std::filesystem::exists(info_of(recently_deleted)));
+    CHECK(std::filesystem::exists(info_of(on_missing_drive)));
+    CHECK(std::filesystem::exists(info_of(recent_on_missing_drive)));
+
+    CHECK(!std::filesystem::exists(archive_folder / "archived long ago"));
+}
+#endif
@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include "Cool/Task/Task.hpp"
+
+struct ProjectInfoFolder {
+    std::filesystem::path file_path{};
+    std::filesystem::path info_folder_path{};
+};
+
+struct ProjectsInfoCompaction {
+    std::vector<std::filesystem::path> removed_projects{};                // They were the same file as another project. Their info folder has been archived
+    std::vector<std::filesystem::path> projects_with_merged_duplicates{}; // Several info folders pointed to this project, they have been merged into one
+    std::vector<ProjectInfoFolder>     missing_projects{};                // Their file is missing, but it might come back (moved or renamed by the user, drive that is not connected, network share that is down). We need the user's consent to archive them
+};
+
+/// Where the Task_CompactProjectsInfo and the Task_ArchiveProjectsInfo put their results, until the ProjectManager picks them up on the main thread and removes the projects from the index
+struct IncomingProjectsInfoCompaction {
+    std::mutex                            mutex{};
+    std::optional<ProjectsInfoCompaction> compaction{};
+    std::vector<std::filesystem::path>    archived_projects{}; // By the Task_ArchiveProjectsInfo. They are already out of the list
+};
+
+/// Archives the info folders that don't correspond to a project anymore, so that the startup scan and the list of projects only grow with the projects that actually exist.
+/// The broken info folders (a creation that failed halfway) and the duplicates would otherwise be read on every startup, forever. The projects whose file is missing are only archived once the user agrees.
+class Task_CompactProjectsInfo : public Cool::Task {
+public:
+    explicit Task_CompactProjectsInfo(std::shared_ptr<IncomingProjectsInfoCompaction> incoming_compaction)
+        : _incoming_compaction{std::move(incoming_compaction)}
+    {}
+
+    auto name() const -> std::string override { return "Cleaning up the info of the projects"; }
+
+private:
+    void execute() override;
+
+    auto is_quick_task() const -> bool override { return false; }
+    auto needs_user_confirmation_to_cancel_when_closing_app() const -> bool override { return false; } // It will just run again the next time the launcher starts
+    void cancel() override { _cancel.store(true); }
+
+private:
+    std::shared_ptr<IncomingProjectsInfoCompaction> _incoming_compaction;
+    std::atomic<bool>                               _cancel{false};
+};
+
+/// Archives the info folders of the projects that the user has agreed to remove from the list, without touching their project file
+class Task_ArchiveProjectsInfo : public Cool::Task {
+public:
+    Task_ArchiveProjectsInfo(std::vector<ProjectInfoFolder> projects, std::shared_ptr<IncomingProjectsInfoCompaction> incoming_compaction)
+        : _projects{std::move(projects)}
+        , _incoming_compaction{std::move(incoming_compaction)}
+    {}
+
+    auto name() const -> std::string override { return _projects.size() == 1 ? "Removing a project from the list" : fmt::format("Removing {} projects from the list", _projects.size()); }
+
+private:
+    void execute() override;
+
+    auto is_quick_task() const -> bool override { return true; }
+    auto needs_user_confirmation_to_cancel_when_closing_app() const -> bool override { return false; }
+    void cancel() override {}
+
+private:
+    std::vector<ProjectInfoFolder>                  _projects;
+    std::shared_ptr<IncomingProjectsInfoCompaction> _incoming_compaction;
+};
+
+/// Deletes the info folders that the ProjectsCrawler has created for a project that is already in the list under another path (hard link, bind mount, etc.), so that the scan doesn't find them again on next startup
+class Task_DeleteDuplicateProjectsInfo : public Cool::Task {
+public:
+    explicit Task_DeleteDuplicateProjectsInfo(std::vector<std::filesystem::path> info_folders)
+        : _info_folders{std::move(info_folders)}
+    {}
+
+    auto name() const -> std::string override { return "Cleaning up the info of the projects"; }
+
+private:
+    void execute() override;
+
+    auto is_quick_task() const -> bool override { return true; }
+    auto needs_user_confirmation_to_cancel_when_closing_app() const -> bool override { return false; }
+    void cancel() override {}
+
+private:
+    std::vector<std::filesystem::path> _info_folders;
+};
+
+/// Merges the info folders that point to the same project (keeping the most recent one, and the thumbnail if only the other one has it), and archives the ones that are broken.
+/// Only lists the projects whose file is missing, because they might have been moved or renamed by the user, who can relink them.
+/// The folders that changed less than an hour ago are left alone, because a project might be being created or renamed right now.
+/// The folders that have been in the archive for a few months are deleted for good.
+auto compact_projects_info_folder(
+    std::filesystem::path const&    projects_info_folder,
+    std::filesystem::path const&    archive_folder,
+    std::filesystem::file_time_type now,
+    std::atomic<bool> const&        cancel
+) -> ProjectsInfoCompaction;
@@ -0,0 +1,77 @@
+#include "Task_CopyProject.hpp"
+#include "Cool/File/File.h"
+#include "FileIdentity.hpp"
+#include "ImGuiNotify/ImGuiNotify.hpp"
+#include "copy_file_fast.hpp"
+#include "read_project_version.hpp"
+
+void Task_CopyProject::execute()
+{
+    auto const& destination = _copy->destination;
+    auto const  temporary   = destination.parent_path() / fmt::format(".{}.copying", destination.filename().string()); // Hidden, and without the .coollab extension, so that it never shows up as a project
+    auto const  give_up     = [&]() {
+        Cool::File::remove_file(destination); // The empty file that the ProjectManager created to reserve the name
+        _copy->signal.signal(Status::Canceled);
+    };
+    auto const fail = [&](std::string const& error_message) {
+        ImGuiNotify::send({
+            .type    = ImGuiNotify::Type::Error,
+            .title   = fmt::format("Failed to copy \"{}\"", _source.stem().string()),
+            .content = error_message,
+        });
+        give_up();
+    };
+
+    if (_cancel.load())
+    {
+        give_up();
+        return;
+    }
+    // We copy next to the reserved file and only replace it once the copy is complete, so that the name stays reserved all along and another copy can't pick it
+    Cool::File::remove_file(temporary); // Leftover of a copy that got interrupted
+    auto const success = copy_file_fast(_source, temporary);
+    if (!success.has_value())
+    {
+        fail(success.error());
+        return;
+    }
+    if (_cancel.load())
+    {
+        Cool::File::remove_file(temporary);
+        give_up();
+        return;
+    }
+    {
+        auto error_code = std::error_code{};
+        std::filesystem::rename(temporary, destination, error_code);
+        if (error_code)
+        {
+            Cool::File::remove_file(temporary);
+            fail(error_code.message());
+            return;
+        }
+    }
+
+    auto error_code = std::error_code{};
+    std::filesystem::create_directories(_destination_info_folder, error_code);
+    std::ignore = copy_file_fast(_source_info_folder / "thumbnail.png", _destination_info_folder / "thumbnail.png"); // The project might not have a thumbnail, that's fine
+    // path.txt is written last, because its last write time is the time of last change of the project
+    if (!Cool::File::set_content(_destination_info_folder / "path.txt", destination.string()))
+    {
+        Cool::File::remove_folder(_destination_info_folder);
+        fail(fmt::format("Make sure you have the permission to write files in the folder \"{}\"", _destination_info_folder.parent_path()));
+        return;
+    }
+
+    // Read everything the UI will need now, so that it doesn't have to touch the file system
+    auto entry = ProjectsIndexEntry{
+        .file_path           = destination,
+        .time_of_last_change = static_cast<int64_t>(std::filesystem::last_write_time(_destination_info_folder / "path.txt", error_code).time_since_epoch().count()),
+        .version             = read_project_version(destination),
+        .file_identity       = file_identity(destination),
+    };
+    if (auto const time_of_version = std::filesystem::last_write_time(destination, error_code); !error_code)
+        entry.time_of_version = static_cast<int64_t>(time_of_version.time_since_epoch().count());
+    _copy->entry = std::move(entry);
+    _copy->signal.signal(Status::Completed);
+}
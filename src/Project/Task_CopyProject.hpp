@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include "Cool/Task/Task.hpp"
+#include "StatusSignal.hpp"
+#include "projects_index.hpp"
+
+/// Shared between the Task_CopyProject and the ProjectManager, which shows the copy in the list as pending until `signal` is signaled
+struct ProjectCopy {
+    std::filesystem::path destination{};
+    ProjectsIndexEntry    entry{}; // Written by the task before it signals Completed, so it can be read once the signal is Completed
+    StatusSignal          signal{};
+};
+
+/// Copies a project file, its thumbnail and creates its info folder, without blocking the UI
+class Task_CopyProject : public Cool::Task {
+public:
+    Task_CopyProject(std::filesystem::path source, std::filesystem::path source_info_folder, std::filesystem::path destination_info_folder, std::shared_ptr<ProjectCopy> copy)
+        : _source{std::move(source)}
+        , _source_info_folder{std::move(source_info_folder)}
+        , _destination_info_folder{std::move(destination_info_folder)}
+        , _copy{std::move(copy)}
+    {}
+
+    auto name() const -> std::string override { return fmt::format("Copying project \"{}\"", _source.stem().string()); }
+
+private:
+    void execute() override;
+
+    auto is_quick_task() const -> bool override { return false; }
+    auto needs_user_confirmation_to_cancel_when_closing_app() const -> bool override { return true; }
+    void cancel() override { _cancel.store(true); }
+
+private:
+    std::filesystem::path        _source;
+    std::filesystem::path        _source_info_folder;
+    std::filesystem::path        _destination_info_folder;
+    std::shared_ptr<ProjectCopy> _copy;
+    std::atomic<bool>            _cancel{false};
+};
@@ -0,0 +1,43 @@
+#include "Task_DeleteProjects.hpp"
+#include "ImGuiNotify/ImGuiNotify.hpp"
+
+void Task_DeleteProjects::execute()
+{
+    auto deleted_projects = std::vector<std::filesystem::path>{};
+    auto failures         = std::vector<std::string>{};
+    for (auto const& project : _projects)
+    {
+        if (_cancel.load())
+            break;
+        auto error_code = std::error_code{};
+        std::filesystem::remove(project.file_path, error_code); // Doesn't fail if the file doesn't exist, which is what happens when deleting projects whose file is missing
+        if (error_code)
+        {
+            // They will show up again in the list the next time the launcher starts
+            failures.push_back(fmt::format("\"{}\": {}", project.file_path.string(), error_code.message()));
+            continue;
+        }
+        std::filesystem::remove_all(project.info_folder_path, error_code);
+        deleted_projects.push_back(project.file_path);
+    }
+    if (!deleted_projects.empty())
+    {
+        std::unique_lock lock{_incoming_deleted_projects->mutex};
+        std::move(deleted_projects.begin(), deleted_projects.end(), std::back_inserter(_incoming_deleted_projects->file_paths));
+    }
+
+    if (!failures.empty())
+    {
+        static constexpr size_t max_nb_failures_to_show{5};
+        auto                    content = std::string{};
+        for (size_t i = 0; i < std::min(failures.size(), max_nb_failures_to_show); ++i)
+            content += failures[i] + '\n';
+        if (failures.size() > max_nb_failures_to_show)
+            content += fmt::format("and {} more", failures.size() - max_nb_failures_to_show);
+        ImGuiNotify::send({
+            .type    = ImGuiNotify::Type::Warning,
+            .title   = failures.size() == 1 ? "Failed to delete a project"s : fmt::format("Failed to delete {} projects", failures.size()),
+            .content = content,
+        });
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include "Cool/Task/Task.hpp"
+
+struct ProjectToDelete {
+    std::filesystem::path file_path;
+    std::filesystem::path info_folder_path;
+};
+
+/// Where the Task_DeleteProjects puts the projects it has deleted, until the ProjectManager removes them from the index on the main thread
+struct IncomingDeletedProjects {
+    std::mutex                         mutex{};
+    std::vector<std::filesystem::path> file_paths{};
+};
+
+/// Deletes the files of several projects at once, and hands them back at the end so that they are removed from the index with a single write.
+/// The ProjectManager removes them from the list before submitting this task, so the UI doesn't wait for the file system.
+class Task_DeleteProjects : public Cool::Task {
+public:
+    Task_DeleteProjects(std::vector<ProjectToDelete> projects, std::shared_ptr<IncomingDeletedProjects> incoming_deleted_projects)
+        : _projects{std::move(projects)}
+        , _incoming_deleted_projects{std::move(incoming_deleted_projects)}
+    {}
+
+    auto name() const -> std::string override { return _projects.size() == 1 ? "Deleting a project" : fmt::format("Deleting {} projects", _projects.size()); }
+
+private:
+    void execute() override;
+
+    auto is_quick_task() const -> bool override { return false; }
+    auto needs_user_confirmation_to_cancel_when_closing_app() const -> bool override { return false; } // If it gets canceled, the scan will remove the remaining deleted projects from the index the next time the launcher starts
+    void cancel() override { _cancel.store(true); }
+
+private:
+    std::vector<ProjectToDelete>             _projects;
+    std::shared_ptr<IncomingDeletedProjects> _incoming_deleted_projects;
+    std::atomic<bool>                        _cancel{false};
+};
@@ -0,0 +1,191 @@
+#include "Task_ScanProjects.hpp"
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include "Cool/Log/Log.hpp"
+#include "Cool/Utils/hash_project_path_for_info_folder.hpp"
+#include "FileIdentity.hpp"
+#include "Path.hpp"
+#include "read_project_version.hpp"
+
+void Task_ScanProjects::execute()
+{
+    auto projects_in_index = std::unordered_map<std::string, ProjectsIndexEntry const*>{};
+    for (auto const& entry : _projects_in_index)
+        projects_in_index[Cool::hash_project_path_for_info_folder(entry.file_path)] = &entry;
+
+    auto new_index       = std::vector<ProjectsIndexEntry>{};
+    auto new_index_mutex = std::mutex{};
+    scan_projects_info_folder(
+        Path::projects_info_folder(),
+        projects_in_index,
+        [&](std::vector<ProjectsIndexEntry>&& entries) {
+            auto projects = std::vector<Project>{};
+            projects.reserve(entries.size());
+            for (auto const& entry : entries)
+                projects.emplace_back(entry);
+            {
+                std::unique_lock lock{new_index_mutex};
+                std::move(entries.begin(), entries.end(), std::back_inserter(new_index));
+            }
+            std::unique_lock lock{_incoming_projects->mutex};
+            std::move(projects.begin(), projects.end(), std::back_inserter(_incoming_projects->projects));
+        },
+        _cancel
+    );
+    std::unique_lock lock{_incoming_projects->mutex};
+    if (!_cancel.load())
+        _incoming_projects->new_index = std::move(new_index);
+    _incoming_projects->scan_is_done = true;
+}
+
+static auto read_project(std::filesystem::path const& info_folder, ProjectsIndexEntry const* entry_in_index) -> std::optional<ProjectsIndexEntry>
+{
+    auto const path_file           = info_folder / "path.txt";
+    auto       error_code          = std::error_code{};
+    auto const time_of_last_change = std::filesystem::last_write_time(path_file, error_code);
+    if (error_code)
+        return std::nullopt; // TODO(Launcher) error
+
+    auto entry = ProjectsIndexEntry{.time_of_last_change = static_cast<int64_t>(time_of_last_change.time_since_epoch().count())};
+    if (entry_in_index)
+    {
+        entry.file_path = entry_in_index->file_path;
+    }
+    else
+    {
+        auto file = std::ifstream{path_file};
+        if (!file.is_open())
+            return std::nullopt; // TODO(Launcher) error
+        auto path = std::string{};
+        std::getline(file, path);
+        entry.file_path = Cool::File::weakly_canonical(path); // So that it is the same as Project::file_path(), which is what we use everywhere else
+    }
+
+    auto const time_of_version = std::filesystem::last_write_time(entry.file_path, error_code);
+    if (error_code)
+        return entry; // The project file doesn't exist (anymore), so there is no version to read
+    entry.time_of_version = static_cast<int64_t>(time_of_version.time_since_epoch().count());
+    entry.file_identity   = file_identity(entry.file_path);
+    // The version we cached is only valid if the project file hasn't been modified since then
+    entry.version = entry_in_index && entry_in_index->time_of_version == entry.time_of_version
+                        ? entry_in_index->version
+                        : read_project_version(entry.file_path);
+    return entry;
+}
+
+void scan_projects_info_folder(
+    std::filesystem::path const&                                      projects_info_folder,
+    std::unordered_map<std::string, ProjectsIndexEntry const*> const& projects_in_index,
+    std::function<void(std::vector<ProjectsIndexEntry>&&)> const&     on_projects_found,
+    std::atomic<bool> const&                                          cancel
+)
+{
+    // Listing the folder is a single cheap call. Reading each path.txt is what's slow (especially on network drives), so that's what we spread over several threads
+    auto info_folders = std::vector<std::filesystem::path>{};
+    try
+    {
+        for (auto const& entry : std::filesystem::directory_iterator{projects_info_folder})
+        {
+            if (!entry.is_directory())
+            {
+                assert(false);
+                continue;
+            }
+            info_folders.push_back(entry.path());
+        }
+    }
+    catch (std::exception const& e)
+    {
+        Cool::Log::internal_warning("Scan projects", e.what());
+    }
+
+    static constexpr size_t batch_size{64}; // Small enough that the first projects show up quickly, big enough that we don't spend our time locking the mutex of the receiver
+    auto                    next_index = std::atomic<size_t>{0};
+    auto const              work       = [&]() {
+        auto batch = std::vector<ProjectsIndexEntry>{};
+        while (!cancel.load())
+        {
+            auto const index = next_index.fetch_add(1);
+            if (index >= info_folders.size())
+                break;
+            auto const it = projects_in_index.find(info_folders[index].filename().string());
+            if (auto entry = read_project(info_folders[index], it != projects_in_index.end() ? it->second : nullptr))
+                batch.push_back(std::move(*entry));
+            if (batch.size() >= batch_size)
+            {
+                on_projects_found(std::move(batch));
+                batch.clear();
+            }
+        }
+        if (!batch.empty())
+            on_projects_found(std::move(batch));
+    };
+
+    // More threads than cores, because they spend most of their time waiting on the file system, not computing
+    auto const nb_threads = std::min<size_t>(std::clamp(std::thread::hardware_concurrency() * 2, 4u, 32u), std::max<size_t>(info_folders.size() / batch_size, 1));
+    auto       threads    = std::vector<std::thread>{};
+    for (size_t i = 1; i < nb_threads; ++i)
+        threads.emplace_back(work);
+    work(); // The current thread works too
+    for (auto& thread : threads)
+        thread.join();
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include <chrono>
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+TEST_CASE("Benchmark: scanning 10k projects" * doctest::skip()) // Run with --no-skip
+{
+    auto const folder = TemporaryFolder{"Projects Info benchmark"};
+    for (int i = 0; i < 10'000; ++i)
+    {
+        auto const info_folder = folder / std::to_string(i);
+        std::filesystem::create_directories(info_folder);
+        auto file = std::ofstream{info_folder / "path.txt"};
+        file << fmt::format("/some/folder/project {}.coollab", i);
+    }
+
+    // What we used to do: read all the path.txt on a single thread, and stat them again in the comparator of the sort
+    auto       sequential          = std::vector<std::filesystem::path>{};
+    auto const duration_sequential = duration_of([&]() {
+        for (auto const& entry : std::filesystem::directory_iterator{folder.path()})
+        {
+            auto file = std::ifstream{entry.path() / "path.txt"};
+            auto path = std::string{};
+            std::getline(file, path);
+            sequential.push_back(entry.path());
+        }
+        std::sort(sequential.begin(), sequential.end(), [](std::filesystem::path const& a, std::filesystem::path const& b) {
+            return std::filesystem::last_write_time(a / "path.txt") > std::filesystem::last_write_time(b / "path.txt");
+        });
+    });
+
+    auto       mutex               = std::mutex{};
+    auto       projects            = std::vector<ProjectsIndexEntry>{};
+    auto       cancel              = std::atomic<bool>{false};
+    auto       time_to_first_batch = std::chrono::milliseconds{};
+    auto const begin               = std::chrono::steady_clock::now();
+    auto const duration_parallel   = duration_of([&]() {
+        scan_projects_info_folder(
+            folder.path(),
+            {},
+            [&](std::vector<ProjectsIndexEntry>&& batch) {
+                std::unique_lock lock{mutex};
+                if (projects.empty())
+                    time_to_first_batch = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+                std::move(batch.begin(), batch.end(), std::back_inserter(projects));
+            },
+            cancel
+        );
+        std::sort(projects.begin(), projects.end(), [](ProjectsIndexEntry const& a, ProjectsIndexEntry const& b) {
+            return a.time_of_last_change > b.time_of_last_change;
+        });
+    });
+
+    CHECK(projects.size() == sequential.size());
+    MESSAGE(fmt::format("{} projects. Sequential: {}ms. Parallel: {}ms (first projects available after {}ms)", projects.size(), duration_sequential.count(), duration_parallel.count(), time_to_first_batch.count()));
+}
+#endif
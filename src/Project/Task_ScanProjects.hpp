@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include "Cool/Task/Task.hpp"
+#include "Project.hpp"
+
+/// Where the Task_ScanProjects puts the projects it finds, until the ProjectManager picks them up on the main thread
+struct IncomingProjects {
+    std::mutex                                     mutex{};
+    std::vector<Project>                           projects{};
+    std::optional<std::vector<ProjectsIndexEntry>> new_index{}; // Set when the scan is done (unless it has been canceled). The ProjectManager writes it, because it owns the index file
+    bool                                           scan_is_done{false};
+};
+
+/// Reads all the "Projects Info" folders and the versions of all the projects in parallel, so that the list of projects doesn't block the startup of the launcher
+class Task_ScanProjects : public Cool::Task {
+public:
+    Task_ScanProjects(std::shared_ptr<IncomingProjects> incoming_projects, std::vector<ProjectsIndexEntry> projects_in_index)
+        : _incoming_projects{std::move(incoming_projects)}
+        , _projects_in_index{std::move(projects_in_index)}
+    {}
+
+    auto name() const -> std::string override { return "Loading the list of projects"; }
+
+private:
+    void execute() override;
+
+    auto is_quick_task() const -> bool override { return false; }
+    auto needs_user_confirmation_to_cancel_when_closing_app() const -> bool override { return false; }
+    void cancel() override { _cancel.store(true); }
+
+private:
+    std::shared_ptr<IncomingProjects> _incoming_projects;
+    std::vector<ProjectsIndexEntry>   _projects_in_index;
+    std::atomic<bool>                 _cancel{false};
+};
+
+/// Reads the path.txt of each folder in `projects_info_folder`, spread over several threads, and calls `on_projects_found` (from any of these threads) with batches of projects as they get resolved.
+/// The time of last change and the version of each project are read once here, so that sorting them and drawing them later doesn't have to touch the file system.
+/// The path.txt of the projects that are in `projects_in_index` (keyed by the name of their info folder) don't need to be read, we only check their time of last change.
+/// Their version doesn't need to be read either, as long as their project file hasn't been modified since it was written in the index.
+void scan_projects_info_folder(
+    std::filesystem::path const&                                      projects_info_folder,
+    std::unordered_map<std::string, ProjectsIndexEntry const*> const& projects_in_index,
+    std::function<void(std::vector<ProjectsIndexEntry>&&)> const&     on_projects_found,
+    std::atomic<bool> const&                                          cancel
+);
@@ -0,0 +1,175 @@
+#include "copy_file_fast.hpp"
+#include "Cool/get_system_error.hpp"
+#include "FileDescriptor.hpp"
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <array>
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>
+#endif
+
+#if defined(__linux__)
+/// Returns false if the file system doesn't support it, in which case nothing has been written yet and we can use another method
+static auto copy_with_copy_file_range(int source, int destination, off_t size) -> tl::expected<bool, std::string>
+{
+    off_t nb_bytes_copied{0};
+    while (nb_bytes_copied < size)
+    {
+        auto const res = copy_file_range(source, nullptr, destination, nullptr, static_cast<size_t>(size - nb_bytes_copied), 0);
+        if (res > 0)
+        {
+            nb_bytes_copied += res;
+            continue;
+        }
+        if (res == 0)
+            break; // The file got shorter while we were copying it
+        if (errno == EINTR)
+            continue;
+        if (nb_bytes_copied == 0 && (errno == EXDEV || errno == ENOSYS || errno == EOPNOTSUPP || errno == EINVAL))
+            return false;
+        return tl::make_unexpected(Cool::get_system_error());
+    }
+    return true;
+}
+
+static auto copy_with_buffer(int source, int destination) -> tl::expected<void, std::string>
+{
+    auto buffer = std::array<char, 1024 * 1024>{};
+    while (true)
+    {
+        auto const nb_bytes_read = read(source, buffer.data(), buffer.size());
+        if (nb_bytes_read == 0)
+            return {};
+        if (nb_bytes_read < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return tl::make_unexpected(Cool::get_system_error());
+        }
+        for (ssize_t nb_bytes_written = 0; nb_bytes_written < nb_bytes_read;)
+        {
+            auto const res = write(destination, buffer.data() + nb_bytes_written, static_cast<size_t>(nb_bytes_read - nb_bytes_written));
+            if (res < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return tl::make_unexpected(Cool::get_system_error());
+            }
+            nb_bytes_written += res;
+        }
+    }
+}
+
+static auto copy_file_linux(std::filesystem::path const& from, std::filesystem::path const& to) -> tl::expected<void, std::string>
+{
+    auto const source = FileDescriptor{open(from.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (source.get() == -1)
+        return tl::make_unexpected(Cool::get_system_error());
+    struct stat info{};
+    if (fstat(source.get(), &info) == -1)
+        return tl::make_unexpected(Cool::get_system_error());
+    auto const destination = FileDescriptor{open(to.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, info.st_mode & 0777)};
+    if (destination.get() == -1)
+        return tl::make_unexpected(Cool::get_system_error());
+
+    auto const res = [&]() -> tl::expected<void, std::string> {
+        if (ioctl(destination.get(), FICLONE, source.get()) == 0)
+            return {};
+        auto const done = copy_with_copy_file_range(source.get(), destination.get(), info.st_size);
+        if (!done.has_value())
+            return tl::make_unexpected(done.error());
+        if (*done)
+            return {};
+        return copy_with_buffer(source.get(), destination.get());
+    }();
+    if (!res.has_value())
+        unlink(to.c_str()); // Don't leave a half-copied file behind
+    return res;
+}
+#endif
+
+auto copy_file_fast(std::filesystem::path const& from, std::filesystem::path const& to) -> tl::expected<void, std::string>
+{
+#if defined(__linux__)
+    return copy_file_linux(from, to);
+#else
+#if defined(__APPLE__)
+    if (clonefile(from.c_str(), to.c_str(), 0) == 0)
+        return {};
+#endif
+    // On Windows, CopyFile() (which copy_file() uses) already clones the file when the file system supports it (ReFS / Dev Drive)
+    auto error_code = std::error_code{};
+    if (!std::filesystem::copy_file(from, to, std::filesystem::copy_options::none, error_code))
+    {
+        std::filesystem::remove(to, error_code);
+        return tl::make_unexpected(error_code.message());
+    }
+    return {};
+#endif
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include <fstream>
+#include <sstream>
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+static auto content_of(std::filesystem::path const& path) -> std::string
+{
+    auto file    = std::ifstream{path, std::ios::binary};
+    auto content = std::stringstream{};
+    content << file.rdbuf();
+    return content.str();
+}
+
+TEST_CASE("Copying a file")
+{
+    auto const folder  = TemporaryFolder{"copy_file_fast"};
+    auto       content = std::string{};
+    for (int i = 0; i < 300'000; ++i)
+        content += std::to_string(i);
+    std::ofstream{folder / "source.coollab", std::ios::binary} << content;
+
+    REQUIRE(copy_file_fast(folder / "source.coollab", folder / "copy.coollab").has_value());
+    CHECK(content_of(folder / "copy.coollab") == content);
+
+    SUBCASE("Doesn't overwrite an existing file")
+    {
+        std::ofstream{folder / "existing.coollab", std::ios::binary} << "existing";
+        CHECK(!copy_file_fast(folder / "source.coollab", folder / "existing.coollab").has_value());
+        CHECK(content_of(folder / "existing.coollab") == "existing");
+    }
+    SUBCASE("Fails when the source doesn't exist")
+    {
+        CHECK(!copy_file_fast(folder / "missing.coollab", folder / "copy of missing.coollab").has_value());
+        CHECK(!std::filesystem::exists(folder / "copy of missing.coollab"));
+    }
+}
+
+TEST_CASE("Benchmark: copying a big project" * doctest::skip()) // Run with --no-skip
+{
+    // Put the folder on a Btrfs / XFS / APFS drive to see the effect of reflinks
+    auto const folder = TemporaryFolder{"copy_file_fast benchmark"};
+    {
+        auto file  = std::ofstream{folder / "source.coollab", std::ios::binary};
+        auto chunk = std::string(1024 * 1024, 'a');
+        for (int i = 0; i < 500; ++i)
+            file << chunk;
+    }
+
+    auto const duration_stream = duration_of([&]() {
+        auto source      = std::ifstream{folder / "source.coollab", std::ios::binary};
+        auto destination = std::ofstream{folder / "stream copy.coollab", std::ios::binary};
+        destination << source.rdbuf();
+    });
+    auto const duration_fast = duration_of([&]() {
+        CHECK(copy_file_fast(folder / "source.coollab", folder / "fast copy.coollab").has_value());
+    });
+
+    MESSAGE(fmt::format("Copying 500MB. Stream copy: {}ms. copy_file_fast: {}ms", duration_stream.count(), duration_fast.count()));
+}
+#endif
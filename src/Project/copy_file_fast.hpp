@@ -0,0 +1,11 @@
+#pragma once
+#include <filesystem>
+#include "tl/expected.hpp"
+
+/// Copies a file using the fastest way the file system supports:
+/// - A reflink (Linux: Btrfs, XFS, ...) or a clone (macOS: APFS): the copy shares the data of the original until one of them gets modified, so it is instantaneous whatever the size of the file
+/// - copy_file_range (Linux): the data is copied by the kernel, without going through our memory (and even by the server, on some network file systems)
+/// - Otherwise, a regular buffered copy
+/// `to` must not exist yet. If the copy fails, nothing is left at `to`.
+/// This can still take a while for big files, so call it from a Task.
+auto copy_file_fast(std::filesystem::path const& from, std::filesystem::path const& to) -> tl::expected<void, std::string>;
@@ -0,0 +1,97 @@
+#include "imgui_fixed_height_rows.hpp"
+#include <algorithm>
+#include "imgui.h"
+
+auto imgui_fixed_height_rows(size_t nb_rows, float row_height, std::function<void(size_t row_index)> const& imgui_row) -> VisibleRows
+{
+    auto visible_rows = VisibleRows{.begin = nb_rows, .end = 0};
+    auto clipper      = ImGuiListClipper{};
+    clipper.Begin(static_cast<int>(nb_rows), row_height + ImGui::GetStyle().ItemSpacing.y);
+    while (clipper.Step())
+    {
+        if (clipper.DisplayStart < clipper.DisplayEnd)
+        {
+            visible_rows.begin = std::min(visible_rows.begin, static_cast<size_t>(clipper.DisplayStart));
+            visible_rows.end   = std::max(visible_rows.end, static_cast<size_t>(clipper.DisplayEnd));
+        }
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            ImGui::PushID(i);
+            ImGui::BeginChild("##row", ImVec2{0.f, row_height}, false, ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse); // The child window guarantees the height of the row, whatever its content
+            imgui_row(static_cast<size_t>(i));
+            ImGui::EndChild();
+            ImGui::PopID();
+        }
+    }
+    clipper.End();
+    if (visible_rows.begin > visible_rows.end)
+        return VisibleRows{}; // No row was rendered
+    return visible_rows;
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+TEST_CASE("Benchmark: rendering a list of 10k projects" * doctest::skip()) // Run with --no-skip
+{
+    // Headless ImGui context, we don't need a window nor a renderer to measure the CPU cost of building a frame
+    auto* const previous_context = ImGui::GetCurrentContext();
+    auto* const context          = ImGui::CreateContext();
+    ImGui::SetCurrentContext(context);
+    auto& io       = ImGui::GetIO();
+    io.DisplaySize = ImVec2{1280.f, 720.f};
+    io.DeltaTime   = 1.f / 60.f;
+    {
+        unsigned char* pixels{};
+        int            width{};
+        int            height{};
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    }
+
+    auto paths = std::vector<std::string>{};
+    for (int i = 0; i < 10'000; ++i)
+        paths.push_back(fmt::format("/home/user/Coollab Projects/project {}.coollab", i));
+    float const row_height = ImGui::GetFrameHeightWithSpacing() + 100.f;
+
+    auto const imgui_row = [&](size_t i) {
+        ImGui::SeparatorText(paths[i].c_str());
+        ImGui::Dummy({100.f, 100.f}); // The thumbnail
+        ImGui::SameLine();
+        ImGui::BeginGroup();
+        ImGui::TextUnformatted(paths[i].c_str());
+        ImGui::TextUnformatted("19.0.3");
+        ImGui::SameLine();
+        ImGui::Text("(Will be upgraded to %s)", "19.1.0");
+        ImGui::EndGroup();
+    };
+
+    auto const time_frames = [&](std::function<void()> const& imgui_list) {
+        return average_duration_of(20, [&](int) {
+            ImGui::NewFrame();
+            ImGui::SetNextWindowPos({0.f, 0.f});
+            ImGui::SetNextWindowSize(io.DisplaySize);
+            ImGui::Begin("Projects");
+            imgui_list();
+            ImGui::End();
+            ImGui::EndFrame();
+        });
+    };
+
+    auto const duration_all_rows = time_frames([&]() {
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            ImGui::PushID(static_cast<int>(i));
+            imgui_row(i);
+            ImGui::PopID();
+        }
+    });
+    auto const duration_visible_rows = time_frames([&]() {
+        imgui_fixed_height_rows(paths.size(), row_height, imgui_row);
+    });
+
+    MESSAGE(fmt::format("{} projects, per frame. All the rows: {}us. Only the visible rows: {}us", paths.size(), duration_all_rows.count(), duration_visible_rows.count()));
+    ImGui::DestroyContext(context);
+    ImGui::SetCurrentContext(previous_context);
+}
+#endif
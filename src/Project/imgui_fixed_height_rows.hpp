@@ -0,0 +1,12 @@
+#pragma once
+#include <functional>
+
+struct VisibleRows {
+    size_t begin{};
+    size_t end{}; // Excluded
+};
+
+/// Only calls `imgui_row` for the rows that are visible, so that the cost of a frame depends on the size of the window and not on the number of rows.
+/// Each row is a child window of exactly `row_height`, so that we know the position of all the rows without having to render them.
+/// Returns the rows that have been rendered, so that we can prepare the ones around them (e.g. load their thumbnails) before they become visible.
+auto imgui_fixed_height_rows(size_t nb_rows, float row_height, std::function<void(size_t row_index)> const& imgui_row) -> VisibleRows;
@@ -0,0 +1,211 @@
+#include "projects_index.hpp"
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include "Cool/File/File.h"
+#include "Cool/Log/Log.hpp"
+#include "Path.hpp"
+
+// The index starts with a header line, and then is a journal: each line either adds (or updates) a project, or removes one.
+//   +<TAB>time_of_last_change<TAB>time_of_version<TAB>version<TAB>path
+//   -<TAB>path
+// The path is last because it is the only field that could contain a tab. time_of_version and version can be empty.
+// Changes are appended, and the whole file gets rewritten (i.e. compacted) from time to time.
+
+static constexpr std::string_view header{"Coollab Launcher projects index v2"}; // Change it whenever the format changes, the old indices will then be ignored and rebuilt by the scan
+
+static auto add_line(ProjectsIndexEntry const& entry) -> std::string
+{
+    return fmt::format(
+        "+\t{}\t{}\t{}\t{}\n",
+        entry.time_of_last_change,
+        entry.time_of_version ? std::to_string(*entry.time_of_version) : "",
+        entry.version ? entry.version->as_string() : "",
+        entry.file_path.string()
+    );
+}
+
+static auto removal_line(std::filesystem::path const& file_path) -> std::string
+{
+    return fmt::format("-\t{}\n", file_path.string());
+}
+
+/// Removes the first field from `line` and returns it, or returns std::nullopt if there is no tab left
+static auto pop_field(std::string_view& line) -> std::optional<std::string_view>
+{
+    auto const end = line.find('\t');
+    if (end == std::string_view::npos)
+        return std::nullopt;
+    auto const field = line.substr(0, end);
+    line.remove_prefix(end + 1);
+    return field;
+}
+
+static auto parse_add_line(std::string_view line) -> std::optional<ProjectsIndexEntry>
+{
+    auto const time_of_last_change = pop_field(line);
+    auto const time_of_version     = pop_field(line);
+    auto const version             = pop_field(line);
+    if (!version.has_value())
+        return std::nullopt;
+
+    auto entry = ProjectsIndexEntry{};
+    try
+    {
+        entry.time_of_last_change = std::stoll(std::string{*time_of_last_change});
+        if (!time_of_version->empty())
+            entry.time_of_version = std::stoll(std::string{*time_of_version});
+    }
+    catch (...)
+    {
+        return std::nullopt;
+    }
+    if (!version->empty())
+        entry.version = VersionName::from(std::string{*version});
+    entry.file_path = std::filesystem::path{std::string{line}};
+    return entry;
+}
+
+auto read_projects_index() -> std::optional<std::vector<ProjectsIndexEntry>>
+{
+    auto file = std::ifstream{Path::projects_index_file(), std::ios::binary};
+    if (!file.is_open())
+        return std::nullopt;
+    auto content = std::stringstream{};
+    content << file.rdbuf(); // Read the whole file at once
+
+    auto line = std::string{};
+    if (!std::getline(content, line) || line != header)
+        return std::nullopt; // Written by an older version of the launcher
+
+    auto   entries          = std::vector<std::optional<ProjectsIndexEntry>>{};
+    auto   index_of_project = std::unordered_map<std::string, size_t>{};
+    size_t nb_lines{0};
+    while (std::getline(content, line))
+    {
+        ++nb_lines;
+        if (line.size() < 2 || line[1] != '\t')
+            continue; // Corrupted line, probably because we crashed while appending it. Ignore it
+        auto const data = std::string_view{line}.substr(2);
+        if (line[0] == '+')
+        {
+            auto entry = parse_add_line(data);
+            if (!entry.has_value())
+                continue;
+            auto const key = entry->file_path.string();
+            auto const it  = index_of_project.find(key);
+            if (it != index_of_project.end())
+            {
+                entries[it->second] = std::move(entry);
+            }
+            else
+            {
+                index_of_project[key] = entries.size();
+                entries.push_back(std::move(entry));
+            }
+        }
+        else if (line[0] == '-')
+        {
+            auto const it = index_of_project.find(std::string{data});
+            if (it == index_of_project.end())
+                continue;
+            entries[it->second].reset();
+            index_of_project.erase(it);
+        }
+    }
+
+    auto res = std::vector<ProjectsIndexEntry>{};
+    res.reserve(index_of_project.size());
+    for (auto& entry : entries)
+    {
+        if (entry.has_value())
+            res.push_back(std::move(*entry));
+    }
+
+    if (nb_lines > 2 * res.size() + 100) // The journal has grown too much, compact it
+        write_projects_index(res);
+    return res;
+}
+
+static void write(std::string const& content)
+{
+    // Write to a temporary file and then rename it, so that we never leave a half-written index behind if we crash
+    auto const path     = Path::projects_index_file();
+    auto const tmp_path = std::filesystem::path{path}.replace_extension(".tmp");
+    if (!Cool::File::set_content(tmp_path, content))
+        return;
+    auto error_code = std::error_code{};
+    std::filesystem::rename(tmp_path, path, error_code);
+    if (error_code)
+        Cool::Log::internal_warning("Projects index", error_code.message());
+}
+
+static auto content_of(std::vector<ProjectsIndexEntry> const& entries) -> std::string
+{
+    auto content = fmt::format("{}\n", header);
+    for (auto const& entry : entries)
+        content += add_line(entry);
+    return content;
+}
+
+void write_projects_index(std::vector<ProjectsIndexEntry> const& entries)
+{
+    write(content_of(entries));
+}
+
+void write_projects_index(std::vector<ProjectsIndexEntry> const& entries, uintmax_t snapshot_end)
+{
+    auto content = content_of(entries);
+
+    auto file = std::ifstream{Path::projects_index_file(), std::ios::binary};
+    if (file.is_open() && file.seekg(static_cast<std::streamoff>(snapshot_end)))
+    {
+        auto changes = std::stringstream{};
+        changes << file.rdbuf();
+        auto line = std::string{};
+        while (std::getline(changes, line))
+        {
+            if (line != header) // If there was no index yet, the first change has been appended to an empty file, without a header
+                content += line + '\n';
+        }
+    }
+    file.close(); // Before we replace it
+
+    write(content);
+}
+
+auto projects_index_end() -> uintmax_t
+{
+    auto       error_code = std::error_code{};
+    auto const size       = std::filesystem::file_size(Path::projects_index_file(), error_code);
+    return error_code ? 0 : size;
+}
+
+static void append(std::string const& line)
+{
+    auto file = std::ofstream{Path::projects_index_file(), std::ios::app | std::ios::binary};
+    if (!file.is_open())
+    {
+        Cool::Log::internal_warning("Projects index", "Failed to open the index");
+        return;
+    }
+    file << line;
+}
+
+void append_to_projects_index(ProjectsIndexEntry const& entry)
+{
+    append(add_line(entry));
+}
+
+void append_removal_to_projects_index(std::filesystem::path const& file_path)
+{
+    append(removal_line(file_path));
+}
+
+void append_removals_to_projects_index(std::vector<std::filesystem::path> const& file_paths)
+{
+    auto lines = std::string{};
+    for (auto const& file_path : file_paths)
+        lines += removal_line(file_path);
+    append(lines);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "FileIdentity.hpp"
+#include "Version/VersionName.hpp"
+
+struct ProjectsIndexEntry {
+    std::filesystem::path       file_path{};
+    int64_t                     time_of_last_change{}; // Last write time of the path.txt in the project's info folder, which Coollab updates every time it saves the project
+    std::optional<int64_t>      time_of_version{};     // Last write time of the project file when we read its version, or std::nullopt if the project file doesn't exist
+    std::optional<VersionName>  version{};             // Only meaningful if time_of_version has a value, and only valid as long as the project file still has this last write time
+    std::optional<FileIdentity> file_identity{};       // Not stored in the index file, only known once the project file has been checked by the scan
+};
+
+// The index file has a single owner: all these functions must be called from the main thread. The tasks hand their changes over to the ProjectManager, which writes them.
+
+/// Returns std::nullopt if there is no index yet, in which case the projects need to be migrated from the folders in Path::projects_info_folder()
+/// This is a single file read, so it is fine to call it on the main thread
+auto read_projects_index() -> std::optional<std::vector<ProjectsIndexEntry>>;
+/// Replaces the whole index
+void write_projects_index(std::vector<ProjectsIndexEntry> const&);
+/// Replaces the whole index with `entries`, which is a snapshot of the index at position `snapshot_end` (see projects_index_end()), and keeps the changes that have been appended after that
+void write_projects_index(std::vector<ProjectsIndexEntry> const& entries, uintmax_t snapshot_end);
+/// Where the next change will be appended
+auto projects_index_end() -> uintmax_t;
+/// Cheaper than rewriting the whole index when only one project changes
+void append_to_projects_index(ProjectsIndexEntry const&);
+void append_removal_to_projects_index(std::filesystem::path const& file_path);
+/// All the lines are appended at once
+void append_removals_to_projects_index(std::vector<std::filesystem::path> const& file_paths);
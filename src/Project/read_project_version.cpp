@@ -0,0 +1,43 @@
+#include "read_project_version.hpp"
+#include <array>
+#include <fstream>
+
+auto read_project_version(std::filesystem::path const& project_file_path) -> std::optional<VersionName>
+{
+    auto file = std::ifstream{};
+    file.rdbuf()->pubsetbuf(nullptr, 0); // Unbuffered, otherwise the stream would read a whole block of the file even though we only need a few bytes. Must be called before open()
+    file.open(project_file_path, std::ios::binary);
+    if (!file.is_open())
+        return std::nullopt;
+
+    auto buffer = std::array<char, 64>{}; // Way longer than any version name
+    file.read(buffer.data(), buffer.size());
+    auto const first_line = std::string_view{buffer.data(), static_cast<size_t>(file.gcount())};
+    return VersionName::from(std::string{first_line.substr(0, first_line.find_first_of("\r\n"))});
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+TEST_CASE("Reading the version of a project")
+{
+    auto const folder = TemporaryFolder{"read_project_version"};
+    auto const file   = folder / "project.coollab";
+    auto const write  = [&](std::string const& content) {
+        std::ofstream{file, std::ios::binary} << content;
+    };
+
+    write("19.0.3\n{\"some\": \"json\"}");
+    CHECK(read_project_version(file) == VersionName::from("19.0.3"));
+    write("19.0.3\r\n{\"some\": \"json\"}"); // Saved on Windows
+    CHECK(read_project_version(file) == VersionName::from("19.0.3"));
+    write("19.0.3"); // No content after the version
+    CHECK(read_project_version(file) == VersionName::from("19.0.3"));
+    write(std::string(100'000, 'a'));
+    CHECK(read_project_version(file) == std::nullopt);
+    write("");
+    CHECK(read_project_version(file) == std::nullopt);
+    CHECK(read_project_version(folder / "missing.coollab") == std::nullopt);
+}
+#endif
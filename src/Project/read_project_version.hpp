@@ -0,0 +1,6 @@
+#pragma once
+#include "Version/VersionName.hpp"
+
+/// The version is on the first line of the project file. We only read a few bytes, whatever the size of the file, because project files can be big and live on slow network drives.
+/// This is still a blocking file read, so prefer calling it from a Task (Task_ScanProjects reads the versions of all the projects at startup)
+auto read_project_version(std::filesystem::path const& project_file_path) -> std::optional<VersionName>;
@@ -0,0 +1,35 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include "Cool/Task/WaitToExecuteTask.hpp"
+#include "Status.hpp"
+
+/// A Status shared between the one that produces it and all the tasks that are waiting on it.
+/// The producer calls signal() once its work is done, and the waiting tasks subscribe to it through after(signal).
+class StatusSignal {
+public:
+    void signal(Status status) { _status.store(status, std::memory_order_release); }
+    auto status() const -> Status { return _status.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<Status> _status{Status::Waiting};
+};
+
+class WaitToExecuteTask_StatusSignal : public Cool::WaitToExecuteTask {
+public:
+    explicit WaitToExecuteTask_StatusSignal(std::shared_ptr<StatusSignal const> signal)
+        : _signal{std::move(signal)}
+    {}
+
+    // These are just an atomic load: we don't need to query the object that produces the signal
+    auto wants_to_execute() -> bool override { return _signal->status() == Status::Completed; }
+    auto wants_to_cancel() -> bool override { return _signal->status() == Status::Canceled; }
+
+private:
+    std::shared_ptr<StatusSignal const> _signal;
+};
+
+inline auto after(std::shared_ptr<StatusSignal const> signal) -> std::shared_ptr<Cool::WaitToExecuteTask>
+{
+    return std::make_shared<WaitToExecuteTask_StatusSignal>(std::move(signal));
+}
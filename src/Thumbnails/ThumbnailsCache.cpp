@@ -0,0 +1,226 @@
+#include "ThumbnailsCache.hpp"
+#include <algorithm>
+#include "Cool/Log/Log.hpp"
+#include "Cool/Utils/hash_project_path_for_info_folder.hpp"
+#include "downscale.hpp"
+#include "img/img.hpp"
+
+ThumbnailsCache::ThumbnailsCache(std::filesystem::path cache_folder, size_t size)
+    : _cache_folder{std::move(cache_folder)}
+    , _size{size}
+{
+    auto error_code = std::error_code{};
+    std::filesystem::create_directories(_cache_folder, error_code);
+
+    // Decoding is CPU-heavy, don't take all the cores
+    auto const nb_workers = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+    for (unsigned int i = 0; i < nb_workers; ++i)
+        _workers.emplace_back([this]() { work(); });
+}
+
+ThumbnailsCache::~ThumbnailsCache()
+{
+    {
+        auto lock      = std::unique_lock{_mutex};
+        _wants_to_stop = true;
+    }
+    _condition.notify_all();
+    for (auto& worker : _workers)
+        worker.join();
+}
+
+void ThumbnailsCache::request(std::filesystem::path const& thumbnail_path, size_t priority)
+{
+    auto const key = thumbnail_path.string();
+    if (_handed_over.contains(key))
+        return;
+
+    {
+        auto lock = std::unique_lock{_mutex};
+        if (_in_progress.contains(key) || _finished.contains(key))
+            return;
+        auto const [it, is_new]     = _requests.try_emplace(key, Request{.priority = priority});
+        it->second.priority           = is_new || !it->second.renewed_this_frame ? priority : std::min(it->second.priority, priority);
+        it->second.renewed_this_frame = true;
+    }
+    _condition.notify_one();
+}
+
+void ThumbnailsCache::invalidate(std::filesystem::path const& thumbnail_path)
+{
+    auto const key = thumbnail_path.string();
+    _handed_over.erase(key);
+
+    auto lock = std::unique_lock{_mutex};
+    _finished.erase(key);
+    if (auto const it = _in_progress.find(key); it != _in_progress.end())
+        it->second = true; // Its result will be discarded, and it will be requested again
+}
+
+auto ThumbnailsCache::end_frame() -> std::vector<LoadedThumbnail>
+{
+    auto finished = std::map<std::string, std::optional<RgbaPixels>>{};
+    {
+        auto lock = std::unique_lock{_mutex};
+        std::erase_if(_requests, [](auto const& request) { return !request.second.renewed_this_frame; });
+        for (auto& [_, request] : _requests)
+            request.renewed_this_frame = false;
+        std::swap(finished, _finished);
+    }
+    auto res = std::vector<LoadedThumbnail>{};
+    res.reserve(finished.size());
+    for (auto& [key, pixels] : finished)
+    {
+        _handed_over.insert(key);
+        res.push_back({.thumbnail_path = key, .pixels = std::move(pixels)});
+    }
+    return res;
+}
+
+void ThumbnailsCache::work()
+{
+    while (true)
+    {
+        auto key = std::string{};
+        {
+            auto lock = std::unique_lock{_mutex};
+            _condition.wait(lock, [&]() { return _wants_to_stop || !_requests.empty(); });
+            if (_wants_to_stop)
+                return;
+            // There are only a few requests at any given time (the rows that are close to the visible area), so a linear search is fine
+            auto const it = std::min_element(_requests.begin(), _requests.end(), [](auto const& a, auto const& b) {
+                return a.second.priority < b.second.priority;
+            });
+            key = it->first;
+            _requests.erase(it);
+            _in_progress[key] = false;
+        }
+
+        auto result = load(key);
+
+        auto lock = std::unique_lock{_mutex};
+        bool const has_been_invalidated = _in_progress[key];
+        _in_progress.erase(key);
+        if (!has_been_invalidated)
+            _finished.insert_or_assign(key, std::move(result));
+    }
+}
+
+auto ThumbnailsCache::cache_path(std::filesystem::path const& thumbnail_path) const -> std::filesystem::path
+{
+    return _cache_folder / fmt::format("{}_{}.png", Cool::hash_project_path_for_info_folder(thumbnail_path), _size);
+}
+
+static auto load_image(std::filesystem::path const& path) -> std::optional<RgbaPixels>
+{
+    auto const image = img::load(path, 4, false /*flip_vertically*/);
+    if (!image.has_value())
+    {
+        Cool::Log::internal_warning("Thumbnails", fmt::format("Failed to load \"{}\": {}", path.string(), image.error()));
+        return std::nullopt;
+    }
+    return RgbaPixels{
+        .width  = image->width(),
+        .height = image->height(),
+        .data   = std::vector<uint8_t>(image->data(), image->data() + image->width() * image->height() * 4),
+    };
+}
+
+auto ThumbnailsCache::load(std::filesystem::path const& thumbnail_path) const -> std::optional<RgbaPixels>
+{
+    auto       error_code     = std::error_code{};
+    auto const thumbnail_time = std::filesystem::last_write_time(thumbnail_path, error_code);
+    if (error_code)
+        return std::nullopt; // No thumbnail
+
+    // The cached file has the same last write time as the thumbnail it was generated from, which is how we know it is up to date
+    auto const path       = cache_path(thumbnail_path);
+    auto const cache_time = std::filesystem::last_write_time(path, error_code);
+    if (!error_code && cache_time == thumbnail_time)
+        return load_image(path);
+
+    auto const image = load_image(thumbnail_path);
+    if (!image.has_value())
+        return std::nullopt;
+    auto small_image = downscale_to_fit(*image, _size);
+
+    // Write to a temporary file and then rename it, so that we never read a half-written file
+    auto const tmp_path = std::filesystem::path{path}.replace_extension(".tmp");
+    img::save_png(tmp_path, small_image.width, small_image.height, small_image.data.data(), 4, false /*flip_vertically*/);
+    std::filesystem::last_write_time(tmp_path, thumbnail_time, error_code);
+    if (!error_code)
+        std::filesystem::rename(tmp_path, path, error_code);
+    if (error_code)
+        Cool::Log::internal_warning("Thumbnails", error_code.message()); // We still have the pixels, we will just generate them again next time
+    return small_image;
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+/// Returns what end_frame() hands over for this thumbnail, or std::nullopt if it takes too long
+static auto wait_for_thumbnail(ThumbnailsCache& cache, std::filesystem::path const& thumbnail_path) -> std::optional<ThumbnailsCache::LoadedThumbnail>
+{
+    for (int i = 0; i < 200; ++i)
+    {
+        cache.request(thumbnail_path, 0);
+        for (auto& thumbnail : cache.end_frame())
+        {
+            if (thumbnail.thumbnail_path == thumbnail_path)
+                return std::move(thumbnail);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    return std::nullopt;
+}
+
+TEST_CASE("ThumbnailsCache generates the small thumbnails in the background, and only once")
+{
+    auto const folder         = TemporaryFolder{"ThumbnailsCache"};
+    auto const thumbnail_path = folder / "thumbnail.png";
+    auto       pixels         = std::vector<uint8_t>(300 * 150 * 4, 255);
+    img::save_png(thumbnail_path, 300, 150, pixels.data(), 4, false);
+
+    auto cache = ThumbnailsCache{folder / "cache", 100};
+
+    auto const thumbnail = wait_for_thumbnail(cache, thumbnail_path);
+    REQUIRE(thumbnail.has_value());
+    REQUIRE(thumbnail->pixels.has_value());
+    CHECK(thumbnail->pixels->width == 100);
+    CHECK(thumbnail->pixels->height == 50);
+    auto const small_thumbnail_path = std::filesystem::directory_iterator{folder / "cache"}->path();
+    CHECK(std::filesystem::last_write_time(small_thumbnail_path) == std::filesystem::last_write_time(thumbnail_path));
+
+    SUBCASE("A thumbnail is only handed over once")
+    {
+        cache.request(thumbnail_path, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        CHECK(cache.end_frame().empty());
+    }
+    SUBCASE("A new cache reuses the files generated by the previous one")
+    {
+        auto const time_of_generation = std::filesystem::last_write_time(small_thumbnail_path);
+        auto       other_cache        = ThumbnailsCache{folder / "cache", 100};
+        auto const other_thumbnail    = wait_for_thumbnail(other_cache, thumbnail_path);
+        REQUIRE(other_thumbnail.has_value());
+        CHECK(other_thumbnail->pixels.has_value());
+        CHECK(std::filesystem::last_write_time(small_thumbnail_path) == time_of_generation);
+    }
+    SUBCASE("Invalidating generates the small thumbnail again")
+    {
+        std::filesystem::last_write_time(thumbnail_path, std::filesystem::last_write_time(thumbnail_path) + std::chrono::seconds{1});
+        cache.invalidate(thumbnail_path);
+        auto const new_thumbnail = wait_for_thumbnail(cache, thumbnail_path);
+        REQUIRE(new_thumbnail.has_value());
+        CHECK(new_thumbnail->pixels.has_value());
+        CHECK(std::filesystem::last_write_time(small_thumbnail_path) == std::filesystem::last_write_time(thumbnail_path));
+    }
+    SUBCASE("There is no small thumbnail when there is no thumbnail")
+    {
+        auto const missing_thumbnail = wait_for_thumbnail(cache, folder / "missing.png");
+        REQUIRE(missing_thumbnail.has_value());
+        CHECK(!missing_thumbnail->pixels.has_value());
+    }
+}
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "downscale.hpp"
+
+/// Generates small versions of the thumbnails in the background, and stores them on disk so that we only need to do it once per version of each thumbnail.
+/// Displaying a full-resolution thumbnail in a small frame is wasteful: decoding a big PNG takes a while, and would make the UI stutter.
+/// The small thumbnails are also decoded in the background, so the UI only has to upload their pixels to the GPU.
+class ThumbnailsCache {
+public:
+    struct LoadedThumbnail {
+        std::filesystem::path     thumbnail_path{};
+        std::optional<RgbaPixels> pixels{}; // std::nullopt when there is no thumbnail (e.g. the project has never been saved)
+    };
+
+    /// `size` is the maximum width and height of the generated thumbnails, in pixels
+    ThumbnailsCache(std::filesystem::path cache_folder, size_t size);
+    ~ThumbnailsCache();
+    ThumbnailsCache(ThumbnailsCache const&)                    = delete;
+    auto operator=(ThumbnailsCache const&) -> ThumbnailsCache& = delete;
+    ThumbnailsCache(ThumbnailsCache&&)                         = delete;
+    auto operator=(ThumbnailsCache&&) -> ThumbnailsCache&      = delete;
+
+    /// Asks for the small version of the thumbnail to be loaded in the background, unless it has already been handed over by end_frame().
+    /// The requests with the lowest `priority` are handled first (e.g. use the distance to the visible area of the list).
+    /// Doesn't touch the file system, so it is fine to call it every frame.
+    void request(std::filesystem::path const& thumbnail_path, size_t priority);
+    /// Call this when the thumbnail has been modified, so that we load it again. end_frame() will hand over its new version once it is ready
+    void invalidate(std::filesystem::path const& thumbnail_path);
+    /// Call this once per frame, after all the calls to request(). Returns the thumbnails that have been loaded since the last call, and cancels the requests that have not been renewed during the frame, because they have gone far out of view
+    auto end_frame() -> std::vector<LoadedThumbnail>;
+
+    auto size() const -> size_t { return _size; }
+
+private:
+    void work();
+    auto load(std::filesystem::path const& thumbnail_path) const -> std::optional<RgbaPixels>;
+    auto cache_path(std::filesystem::path const& thumbnail_path) const -> std::filesystem::path;
+
+private:
+    struct Request {
+        size_t priority{};
+        bool   renewed_this_frame{true};
+    };
+
+    std::filesystem::path _cache_folder;
+    size_t                _size;
+
+    // Only accessed from the main thread
+    std::unordered_set<std::string> _handed_over{}; // Until they get invalidated
+
+    // Guarded by _mutex
+    std::map<std::string, Request>                                            _requests{}; // Not started yet
+    std::map<std::string, std::optional<RgbaPixels>>                          _finished{}; // Waiting to be handed over by end_frame()
+    std::unordered_map<std::string, bool /*has_been_invalidated_meanwhile*/> _in_progress{};
+    bool                                                                      _wants_to_stop{false};
+    std::mutex                                                                _mutex{};
+    std::condition_variable                                                   _condition{};
+
+    std::vector<std::thread> _workers{}; // Must be declared last, so that they are started after everything else has been initialized
+};
@@ -0,0 +1,109 @@
+#include "downscale.hpp"
+#include <algorithm>
+#include <array>
+
+static auto fit(size_t width, size_t height, size_t max_size) -> std::pair<size_t, size_t>
+{
+    if (width <= max_size && height <= max_size)
+        return {width, height};
+    if (width >= height)
+        return {max_size, std::max<size_t>((height * max_size + width / 2) / width, 1)};
+    return {std::max<size_t>((width * max_size + height / 2) / height, 1), max_size};
+}
+
+auto downscale_to_fit(RgbaPixels const& source, size_t max_size) -> RgbaPixels
+{
+    auto const [width, height] = fit(source.width, source.height, max_size);
+    if (width == source.width && height == source.height)
+        return source;
+
+    auto res = RgbaPixels{
+        .width  = width,
+        .height = height,
+        .data   = std::vector<uint8_t>(width * height * 4),
+    };
+    for (size_t y = 0; y < height; ++y)
+    {
+        // Source rows covered by this pixel. Because we only downscale, each pixel covers at least one source pixel
+        size_t const begin_y = y * source.height / height;
+        size_t const end_y   = std::max((y + 1) * source.height / height, begin_y + 1);
+        for (size_t x = 0; x < width; ++x)
+        {
+            size_t const begin_x = x * source.width / width;
+            size_t const end_x   = std::max((x + 1) * source.width / width, begin_x + 1);
+
+            auto   sum_color_times_alpha = std::array<uint64_t, 3>{};
+            auto   sum_color             = std::array<uint64_t, 3>{}; // Used when all the pixels are fully transparent
+            size_t sum_alpha{0};
+            for (size_t sy = begin_y; sy < end_y; ++sy)
+            {
+                uint8_t const* pixel = &source.data[(sy * source.width + begin_x) * 4];
+                for (size_t sx = begin_x; sx < end_x; ++sx, pixel += 4)
+                {
+                    for (size_t c = 0; c < 3; ++c)
+                    {
+                        sum_color_times_alpha[c] += static_cast<uint64_t>(pixel[c]) * pixel[3];
+                        sum_color[c] += pixel[c];
+                    }
+                    sum_alpha += pixel[3];
+                }
+            }
+
+            size_t const   nb_pixels = (end_y - begin_y) * (end_x - begin_x);
+            uint8_t* const out       = &res.data[(y * width + x) * 4];
+            for (size_t c = 0; c < 3; ++c)
+            {
+                out[c] = static_cast<uint8_t>(sum_alpha == 0
+                                                  ? (sum_color[c] + nb_pixels / 2) / nb_pixels
+                                                  : (sum_color_times_alpha[c] + sum_alpha / 2) / sum_alpha);
+            }
+            out[3] = static_cast<uint8_t>((sum_alpha + nb_pixels / 2) / nb_pixels);
+        }
+    }
+    return res;
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include "doctest/doctest.h"
+
+TEST_CASE("Downscaling a thumbnail")
+{
+    // 4x2 image: left half opaque red, right half transparent (with some garbage color that must not bleed into the result)
+    auto source = RgbaPixels{.width = 4, .height = 2, .data = {}};
+    for (size_t y = 0; y < 2; ++y)
+    {
+        for (size_t x = 0; x < 4; ++x)
+        {
+            bool const is_left = x < 2;
+            source.data.insert(source.data.end(), {
+                                                      static_cast<uint8_t>(is_left ? 255 : 0),
+                                                      static_cast<uint8_t>(is_left ? 0 : 255),
+                                                      0,
+                                                      static_cast<uint8_t>(is_left ? 255 : 0),
+                                                  });
+        }
+    }
+
+    SUBCASE("The aspect ratio is preserved")
+    {
+        auto const res = downscale_to_fit(source, 2);
+        CHECK(res.width == 2);
+        CHECK(res.height == 1);
+        CHECK(res.data == std::vector<uint8_t>{255, 0, 0, 255, /**/ 0, 255, 0, 0});
+    }
+    SUBCASE("Transparent pixels don't change the color, only the alpha")
+    {
+        auto const res = downscale_to_fit(source, 1);
+        CHECK(res.width == 1);
+        CHECK(res.height == 1);
+        CHECK(res.data == std::vector<uint8_t>{255, 0, 0, 128});
+    }
+    SUBCASE("Small images are not upscaled")
+    {
+        auto const res = downscale_to_fit(source, 100);
+        CHECK(res.width == 4);
+        CHECK(res.height == 2);
+        CHECK(res.data == source.data);
+    }
+}
+#endif
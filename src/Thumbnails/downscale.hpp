@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+struct RgbaPixels {
+    size_t               width{};
+    size_t               height{};
+    std::vector<uint8_t> data{}; // width * height * 4 bytes, row by row
+};
+
+/// Box filter: each pixel of the result is the average of all the source pixels it covers (weighted by their alpha, to avoid dark fringes around transparent areas).
+/// The aspect ratio is preserved, and the image is never upscaled.
+auto downscale_to_fit(RgbaPixels const&, size_t max_size) -> RgbaPixels;
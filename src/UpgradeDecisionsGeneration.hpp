@@ -0,0 +1,20 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/// Bumped every time something that the upgrade decisions depend on changes: the compatibility table, the list of versions, or the launcher settings.
+/// Projects cache their upgrade decisions and only recompute them when the generation has changed.
+class UpgradeDecisionsGeneration {
+public:
+    auto get() const -> uint64_t { return _generation.load(std::memory_order_acquire); }
+    void bump() { _generation.fetch_add(1, std::memory_order_acq_rel); }
+
+private:
+    std::atomic<uint64_t> _generation{0};
+};
+
+inline auto upgrade_decisions_generation() -> UpgradeDecisionsGeneration&
+{
+    static auto instance = UpgradeDecisionsGeneration{};
+    return instance;
+}
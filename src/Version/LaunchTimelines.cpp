@@ -0,0 +1,298 @@
+#include "LaunchTimelines.hpp"
+#include <algorithm>
+#include <fstream>
+#include "Cool/File/File.h"
+#include "Path.hpp"
+#include "fmt/chrono.h"
+#include "imgui.h"
+#include "nlohmann/json.hpp"
+#include "open/open.hpp"
+
+static constexpr size_t max_nb_launches{20}; // Only the most recent ones are kept in memory, the older ones are in the log
+
+auto launch_timelines() -> LaunchTimelines&
+{
+    static auto instance = LaunchTimelines{Path::launch_timelines_log_file()};
+    return instance;
+}
+
+static auto as_string(std::chrono::steady_clock::duration duration) -> std::string
+{
+    auto const ms = std::chrono::duration<double, std::milli>{duration}.count();
+    if (ms < 10.)
+        return fmt::format("{:.2f}ms", ms);
+    if (ms < 1000.)
+        return fmt::format("{:.0f}ms", ms);
+    return fmt::format("{:.2f}s", ms / 1000.);
+}
+
+static auto as_microseconds(std::chrono::steady_clock::duration duration) -> int64_t
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+/// Up to the end of the last step, or up to now if the launch is still in progress
+static auto duration_of(LaunchTimelines::Launch const& launch) -> std::chrono::steady_clock::duration
+{
+    if (!launch.outcome.has_value())
+        return std::chrono::steady_clock::now() - launch.click;
+    auto res = std::chrono::steady_clock::duration{};
+    for (auto const& step : launch.steps)
+        res = std::max(res, step.end);
+    return res;
+}
+
+auto as_log_line(LaunchTimelines::Launch const& launch) -> std::string
+{
+    auto steps = std::string{};
+    for (auto const& step : launch.steps)
+    {
+        if (!steps.empty())
+            steps += ", ";
+        steps += step.is_event
+                     ? fmt::format("{} at {}", step.name, as_string(step.begin))
+                     : fmt::format("{}: {}", step.name, as_string(step.end - step.begin));
+    }
+    return fmt::format(
+        "{:%Y-%m-%d %H:%M:%S} | {} | {} after {} | {}",
+        std::chrono::floor<std::chrono::seconds>(launch.date),
+        launch.description,
+        launch.outcome.value_or("In progress"),
+        as_string(duration_of(launch)),
+        steps
+    );
+}
+
+LaunchTimelines::LaunchTimelines(std::filesystem::path log_file)
+    : _log_file{std::move(log_file)}
+{}
+
+auto LaunchTimelines::find(LaunchId id) -> Launch*
+{
+    auto const it = std::find_if(_launches.begin(), _launches.end(), [&](Launch const& launch) { return launch.id == id; });
+    return it != _launches.end() ? &*it : nullptr; // Might have been dropped, if there have been a lot of launches since then
+}
+
+auto LaunchTimelines::start(std::string description) -> LaunchId
+{
+    auto lock = std::unique_lock{_mutex};
+    _launches.push_back(Launch{
+        .id          = _next_id++,
+        .description = std::move(description),
+        .date        = std::chrono::system_clock::now(),
+        .click       = std::chrono::steady_clock::now(),
+    });
+    if (_launches.size() > max_nb_launches)
+        _launches.pop_front();
+    return _launches.back().id;
+}
+
+void LaunchTimelines::begin_step(LaunchId id, std::string_view name)
+{
+    auto const now    = std::chrono::steady_clock::now();
+    auto       lock   = std::unique_lock{_mutex};
+    auto*      launch = find(id);
+    if (!launch || launch->outcome.has_value())
+        return;
+    launch->steps.push_back(Step{.name = std::string{name}, .begin = now - launch->click});
+}
+
+void LaunchTimelines::end_step(LaunchId id, std::string_view name)
+{
+    auto const now    = std::chrono::steady_clock::now();
+    auto       lock   = std::unique_lock{_mutex};
+    auto*      launch = find(id);
+    if (!launch || launch->outcome.has_value())
+        return;
+    auto const it = std::find_if(launch->steps.rbegin(), launch->steps.rend(), [&](Step const& step) { return step.name == name && !step.is_over; });
+    if (it == launch->steps.rend())
+        return;
+    it->end     = now - launch->click;
+    it->is_over = true;
+}
+
+void LaunchTimelines::add_event(LaunchId id, std::string_view name)
+{
+    auto const now    = std::chrono::steady_clock::now();
+    auto       lock   = std::unique_lock{_mutex};
+    auto*      launch = find(id);
+    if (!launch || launch->outcome.has_value())
+        return;
+    launch->steps.push_back(Step{.name = std::string{name}, .begin = now - launch->click, .end = now - launch->click, .is_event = true, .is_over = true});
+}
+
+void LaunchTimelines::add_event_to_ongoing_launches(std::string_view name)
+{
+    auto const now  = std::chrono::steady_clock::now();
+    auto       lock = std::unique_lock{_mutex};
+    for (auto& launch : _launches)
+    {
+        if (!launch.outcome.has_value())
+            launch.steps.push_back(Step{.name = std::string{name}, .begin = now - launch.click, .end = now - launch.click, .is_event = true, .is_over = true});
+    }
+}
+
+void LaunchTimelines::finish(LaunchId id, std::string_view outcome)
+{
+    auto const now  = std::chrono::steady_clock::now();
+    auto       line = std::string{};
+    {
+        auto  lock   = std::unique_lock{_mutex};
+        auto* launch = find(id);
+        if (!launch || launch->outcome.has_value())
+            return;
+        for (auto& step : launch->steps)
+        {
+            if (step.is_over)
+                continue;
+            step.end     = now - launch->click;
+            step.is_over = true;
+        }
+        launch->outcome = std::string{outcome};
+        line            = as_log_line(*launch);
+    }
+    // Outside of the lock, we don't want to block the other threads while we touch the disk
+    auto file = std::ofstream{_log_file, std::ios::app};
+    file << line << '\n';
+}
+
+auto LaunchTimelines::launches() const -> std::vector<Launch>
+{
+    auto lock = std::unique_lock{_mutex};
+    return {_launches.begin(), _launches.end()};
+}
+
+auto LaunchTimelines::as_chrome_trace() const -> std::string
+{
+    // Cf. https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+    // Each launch is a thread of its own, starting at 0, so that they can be compared side by side
+    auto events = nlohmann::json::array();
+    for (auto const& launch : launches())
+    {
+        auto const tid = launch.id;
+        events.push_back({
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", 1},
+            {"tid", tid},
+            {"args", {{"name", fmt::format("{} ({})", launch.description, launch.outcome.value_or("In progress"))}}},
+        });
+        auto const now = std::chrono::steady_clock::now() - launch.click;
+        for (auto const& step : launch.steps)
+        {
+            if (step.is_event)
+            {
+                events.push_back({{"name", step.name}, {"ph", "i"}, {"s", "t"}, {"pid", 1}, {"tid", tid}, {"ts", as_microseconds(step.begin)}});
+            }
+            else
+            {
+                auto const end = step.is_over ? step.end : now;
+                events.push_back({{"name", step.name}, {"ph", "X"}, {"pid", 1}, {"tid", tid}, {"ts", as_microseconds(step.begin)}, {"dur", as_microseconds(end - step.begin)}});
+            }
+        }
+    }
+    return nlohmann::json{{"traceEvents", events}, {"displayTimeUnit", "ms"}}.dump(4);
+}
+
+void LaunchTimelines::imgui()
+{
+    if (ImGui::Button("Export as Chrome trace"))
+    {
+        if (Cool::File::set_content(Path::launch_timelines_trace_file(), as_chrome_trace()))
+            Cool::open_focused_in_explorer(Path::launch_timelines_trace_file());
+    }
+    ImGui::SetItemTooltip("%s", "Open it in chrome://tracing or https://ui.perfetto.dev to compare the launches of several machines");
+    ImGui::SameLine();
+    if (ImGui::Button("Reveal the log in explorer"))
+        Cool::open_focused_in_explorer(_log_file);
+
+    auto const launches = this->launches();
+    if (launches.empty())
+        ImGui::TextDisabled("%s", "Launch a project to see how long each step takes");
+    for (auto it = launches.rbegin(); it != launches.rend(); ++it) // Most recent first
+    {
+        auto const& launch = *it;
+        auto const  total  = duration_of(launch);
+        ImGui::PushID(static_cast<int>(launch.id));
+        if (ImGui::CollapsingHeader(fmt::format("{}: {} after {}###launch", launch.description, launch.outcome.value_or("In progress"), as_string(total)).c_str()))
+        {
+            // A bar per step, on a common time scale
+            float const width  = ImGui::GetContentRegionAvail().x;
+            float const height = ImGui::GetTextLineHeight() * 0.5f;
+            auto const  now    = std::chrono::steady_clock::now() - launch.click;
+            auto const  x_of   = [&](std::chrono::steady_clock::duration time) {
+                return total.count() > 0 ? width * static_cast<float>(time.count()) / static_cast<float>(total.count()) : 0.f;
+            };
+            for (auto const& step : launch.steps)
+            {
+                auto const end = step.is_over ? step.end : now;
+                if (step.is_event)
+                    ImGui::TextDisabled("%s at %s", step.name.c_str(), as_string(step.begin).c_str());
+                else
+                    ImGui::Text("%s: %s", step.name.c_str(), as_string(end - step.begin).c_str());
+                auto const  position = ImGui::GetCursorScreenPos();
+                float const x_begin  = x_of(step.begin);
+                float const x_end    = std::max(x_of(end), x_begin + 2.f); // So that the events and the very short steps are visible too
+                ImGui::GetWindowDrawList()->AddRectFilled({position.x + x_begin, position.y}, {position.x + x_end, position.y + height}, ImGui::GetColorU32(step.is_event ? ImGuiCol_PlotLines : ImGuiCol_PlotHistogram));
+                ImGui::Dummy({width, height});
+            }
+        }
+        ImGui::PopID();
+    }
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include <thread>
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+TEST_CASE("LaunchTimelines")
+{
+    auto const folder    = TemporaryFolder{"LaunchTimelines"};
+    auto const log_file  = folder / "launch_timelines.log";
+    auto       timelines = LaunchTimelines{log_file};
+
+    auto const id = timelines.start("Opening \"project\"");
+    timelines.begin_step(id, "Waiting for the installation");
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    timelines.add_event_to_ongoing_launches("Fetched the list of versions");
+    std::thread{[&]() { timelines.end_step(id, "Waiting for the installation"); }}.join(); // The steps can end on another thread than the one they started on
+    timelines.begin_step(id, "Spawning Coollab");
+    timelines.finish(id, "Coollab has been launched");
+    timelines.add_event(id, "Ignored, the launch is over");
+
+    auto const launches = timelines.launches();
+    REQUIRE(launches.size() == 1);
+    auto const& steps = launches[0].steps;
+    REQUIRE(steps.size() == 3);
+    CHECK(steps[0].name == "Waiting for the installation");
+    CHECK(steps[0].end - steps[0].begin >= std::chrono::milliseconds{20});
+    CHECK(steps[1].is_event);
+    CHECK(steps[1].begin >= steps[0].begin);
+    CHECK(steps[1].begin <= steps[0].end);
+    CHECK(steps[2].is_over); // Ended by finish()
+    CHECK(steps[2].begin >= steps[0].end);
+
+    SUBCASE("It is written to the log")
+    {
+        auto file = std::ifstream{log_file};
+        auto line = std::string{};
+        std::getline(file, line);
+        CHECK(line == as_log_line(launches[0]));
+        CHECK(line.find("Opening \"project\" | Coollab has been launched after ") != std::string::npos);
+        CHECK(line.find("Fetched the list of versions at ") != std::string::npos);
+    }
+    SUBCASE("It can be exported as a Chrome trace")
+    {
+        auto const json   = nlohmann::json::parse(timelines.as_chrome_trace());
+        auto const events = json.at("traceEvents");
+        REQUIRE(events.size() == 4);
+        CHECK(events[0].at("ph") == "M");
+        CHECK(events[1].at("ph") == "X");
+        CHECK(events[1].at("name") == "Waiting for the installation");
+        CHECK(events[1].at("dur").get<int64_t>() >= 20'000);
+        CHECK(events[2].at("ph") == "i");
+        CHECK(events[3].at("ts").get<int64_t>() >= events[1].at("ts").get<int64_t>() + events[1].at("dur").get<int64_t>());
+    }
+}
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using LaunchId = uint64_t;
+
+/// Records how long each step of a launch takes, from the click in the launcher to the first signal of life from Coollab, so that we can tell where the time goes when "opening a project is slow".
+/// The steps are recorded from whichever thread they happen on (main thread, tasks waiting for an installation, etc.).
+/// Each launch is written to a log file once it is over, and the recent ones can be viewed in a debug window, or exported as a Chrome trace (chrome://tracing, https://ui.perfetto.dev) to compare machines.
+class LaunchTimelines {
+public:
+    struct Step {
+        std::string                         name{};
+        std::chrono::steady_clock::duration begin{}; // Since the click
+        std::chrono::steady_clock::duration end{};   // Same as begin for the events that don't last
+        bool                                is_event{false};
+        bool                                is_over{false};
+    };
+    struct Launch {
+        LaunchId                              id{};
+        std::string                           description{};
+        std::chrono::system_clock::time_point date{}; // For the log
+        std::chrono::steady_clock::time_point click{};
+        std::vector<Step>                     steps{};
+        std::optional<std::string>            outcome{}; // Set once the launch is over
+    };
+
+    explicit LaunchTimelines(std::filesystem::path log_file);
+
+    /// Call it when the user clicks. All the other steps are timed relative to that
+    auto start(std::string description) -> LaunchId;
+    void begin_step(LaunchId, std::string_view name);
+    void end_step(LaunchId, std::string_view name);
+    void add_event(LaunchId, std::string_view name);
+    /// For what happens independently of the launches, but that they might be waiting for (e.g. the list of versions has been fetched, an installation has finished)
+    void add_event_to_ongoing_launches(std::string_view name);
+    /// Ends the steps that are still in progress, and writes the launch to the log
+    void finish(LaunchId, std::string_view outcome);
+
+    /// The most recent launches, oldest first
+    auto launches() const -> std::vector<Launch>;
+    auto as_chrome_trace() const -> std::string;
+    auto log_file() const -> std::filesystem::path const& { return _log_file; }
+    /// The content of the debug window
+    void imgui();
+
+private:
+    /// Must be called with _mutex locked
+    auto find(LaunchId) -> Launch*;
+
+private:
+    std::filesystem::path _log_file;
+    std::deque<Launch>    _launches{};
+    LaunchId              _next_id{0};
+    mutable std::mutex    _mutex{};
+};
+
+auto launch_timelines() -> LaunchTimelines&;
+/// One line per launch
+auto as_log_line(LaunchTimelines::Launch const&) -> std::string;
@@ -1,5 +1,6 @@
 #include "Task_FetchListOfVersions.hpp"
 #include "Cool/Task/TaskManager.hpp"
+#include "LaunchTimelines.hpp"
 #include "Status.hpp"
 #include "VersionManager.hpp"
 #include "make_http_request.hpp"
@@ -70,6 +71,7 @@ void Task_FetchListOfVersions::execute()
     }
 
     version_manager().on_finished_fetching_list_of_versions();
+    launch_timelines().add_event_to_ongoing_launches("Fetched the list of versions");
 
     if (_warning_notification_id.has_value())
         ImGuiNotify::close_immediately(*_warning_notification_id);
@@ -77,6 +79,7 @@ void Task_FetchListOfVersions::execute()
 
 void Task_FetchListOfVersions::handle_error(httplib::Result const& res)
 {
+    launch_timelines().add_event_to_ongoing_launches("Failed to fetch the list of versions");
     Cool::Log::internal_warning(
         "Fetch list of versions",
         !res ? httplib::to_string(res.error())
@@ -121,5 +124,5 @@ void Task_FetchListOfVersions::handle_error(httplib::Result const& res)
     if (!res || message) // Only retry if we failed because we don't have an Internet connection, or because we hit the max number of requests to Github. There is no point in retrying if the service is unavailable, it's probably not gonna get fixed soon, and if we make too many requests to their API, Github will block us
         Cool::task_manager().submit(after(message ? duration_until_reset : 1s), std::make_shared<Task_FetchListOfVersions>(_warning_notification_id));
     else
-        version_manager()._status_of_fetch_list_of_versions.store(Status::Canceled);
+        version_manager()._fetch_list_of_versions_signal->signal(Status::Canceled);
 }
\ No newline at end of file
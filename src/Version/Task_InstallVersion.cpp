@@ -3,8 +3,11 @@
 #include "Cool/File/File.h"
 #include "Cool/ImGui/markdown.h"
 #include "ImGuiNotify/ImGuiNotify.hpp"
+#include "LaunchTimelines.hpp"
+#include "LauncherSettings.hpp"
 #include "Version.hpp"
 #include "VersionManager.hpp"
+#include "extract_appimage.hpp"
 #include "httplib.h"
 #include "installation_path.hpp"
 #include "make_http_request.hpp"
@@ -216,12 +219,17 @@ void Task_InstallVersion::cleanup(bool has_been_canceled)
 
     if (has_been_canceled || _error_message.has_value())
     {
+        Cool::File::remove_folder(installation_path(*_version_name)); // Cleanup any files that we might have started to extract from the zip. Must be done before setting the installation status, which marks the installed versions index as outdated
         version_manager().set_installation_status(*_version_name, InstallationStatus::NotInstalled);
-        Cool::File::remove_folder(installation_path(*_version_name)); // Cleanup any files that we might have started to extract from the zip
+        if (_installation_signal)
+            _installation_signal->signal(Status::Canceled);
     }
     else
     {
         version_manager().set_installation_status(*_version_name, InstallationStatus::Installed);
+        launch_timelines().add_event_to_ongoing_launches(fmt::format("Installed {}", _version_name->as_string()));
+        if (_installation_signal)
+            _installation_signal->signal(Status::Completed); // After setting the installation status, because the tasks waiting for it will look for an installed version
     }
 }
 
@@ -255,6 +263,7 @@ void Task_InstallVersion::execute()
     }
 
     TaskWithProgressBar::change_notification_when_execution_starts(); // Must be done after finding the _changelog_url, because this will call extra_imgui_below_progress_bar(), which needs _changelog_url
+    launch_timelines().add_event_to_ongoing_launches(fmt::format("Started downloading {}", _version_name->as_string()));
 
     // Download zip
     auto const zip = download_zip(*_download_url, [&](float progress) { set_progress(progress * 0.99f); }, [&]() { return cancel_requested(); });
@@ -265,6 +274,7 @@ void Task_InstallVersion::execute()
         _error_message = zip.error();
         return;
     }
+    launch_timelines().add_event_to_ongoing_launches(fmt::format("Downloaded {}", _version_name->as_string()));
 
     { // Extract zip
         auto const success = extract_zip(*zip, *_version_name, [&]() { return cancel_requested(); });
@@ -285,4 +295,16 @@ void Task_InstallVersion::execute()
             return;
         }
     }
+
+#if defined(__linux__)
+    if (launcher_settings().extract_appimages_at_installation && !cancel_requested())
+    { // Extract the AppImage, so that launching doesn't have to mount it with FUSE every time
+        auto const appimage = executable_path(*_version_name);
+        auto const success  = extract_appimage(appimage, extracted_appimage_path(*_version_name), [&]() { return cancel_requested(); });
+        if (success.has_value())
+            Cool::File::remove_file(appimage); // executable_path() is now the AppRun, and we don't want to use twice the disk space
+        else if (!cancel_requested())
+            Cool::Log::internal_warning("Extract AppImage", success.error()); // Not an error, the version can still be launched through its AppImage
+    }
+#endif
 }
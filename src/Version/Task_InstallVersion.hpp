@@ -1,13 +1,16 @@
 #pragma once
 #include "Cool/Task/TaskWithProgressBar.hpp"
 #include "ImGuiNotify/ImGuiNotify.hpp"
+#include "StatusSignal.hpp"
 #include "VersionName.hpp"
 
 class Task_InstallVersion : public Cool::TaskWithProgressBar {
 public:
     Task_InstallVersion() = default; // Will install the latest version, because we don't specify a version name
-    explicit Task_InstallVersion(VersionName version_name)
+    /// `installation_signal` is signaled once the installation status of the version has been set, so that the tasks waiting for this installation can run
+    Task_InstallVersion(VersionName version_name, std::shared_ptr<StatusSignal> installation_signal)
         : _version_name{std::move(version_name)}
+        , _installation_signal{std::move(installation_signal)}
     {}
     auto name() const -> std::string override { return fmt::format("Installing {}", _version_name ? _version_name->as_string() : "latest version"); }
 
@@ -25,6 +28,7 @@ private:
     std::optional<VersionName> _version_name{};
     std::optional<std::string> _download_url{};
     std::optional<std::string> _changelog_url{};
+    std::shared_ptr<StatusSignal> _installation_signal{}; // Only when we know the version name from the start
 
     std::optional<std::string> _error_message{};
 };
@@ -2,17 +2,23 @@
 #include <exe_path/exe_path.h>
 #include <ImGuiNotify/ImGuiNotify.hpp>
 #include <filesystem>
+#include <thread>
 #include <vector>
 #include "Cool/AppManager/close_application.hpp"
 #include "Cool/DebugOptions/DebugOptions.h"
 #include "Cool/File/File.h"
+#include "Cool/Log/file_logger_path.hpp"
 #include "Cool/Task/TaskManager.hpp"
+#include "Cool/Utils/hash_project_path_for_info_folder.hpp"
 #include "Cool/Utils/overloaded.hpp"
 #include "Cool/spawn_process.hpp"
+#include "DebugOptions/DebugOptions.hpp"
 #include "Path.hpp"
 #include "Version/VersionRef.hpp"
 #include "VersionManager.hpp"
+#include "hand_over_to_running_instance.hpp"
 #include "installation_path.hpp"
+#include "version_usage.hpp"
 
 auto Task_LaunchVersion::name() const -> std::string
 {
@@ -32,14 +38,16 @@ auto Task_LaunchVersion::name() const -> std::string
     );
 }
 
-Task_LaunchVersion::Task_LaunchVersion(VersionRef version_ref, ProjectToOpenOrCreate project_to_open_or_create)
+Task_LaunchVersion::Task_LaunchVersion(VersionRef version_ref, ProjectToOpenOrCreate project_to_open_or_create, LaunchId launch_id)
     : Cool::Task{reg::generate_uuid() /* give a unique id to this task, so that we can cancel it */}
     , _version_ref{std::move(version_ref)}
     , _project_to_open_or_create{std::move(project_to_open_or_create)}
+    , _launch_id{launch_id}
 {}
 
 void Task_LaunchVersion::on_submit()
 {
+    launch_timelines().begin_step(_launch_id, "Waiting for the version to be installed");
     _notification_id = ImGuiNotify::send({
         .type                 = ImGuiNotify::Type::Info,
         .title                = name(),
@@ -53,8 +61,10 @@ void Task_LaunchVersion::on_submit()
     });
 }
 
-void Task_LaunchVersion::cleanup(bool /* has_been_canceled */)
+void Task_LaunchVersion::cleanup(bool has_been_canceled)
 {
+    // Does nothing if execute() has already finished it
+    launch_timelines().finish(_launch_id, has_been_canceled ? "Canceled"s : !_error_message.empty() ? _error_message : "Coollab has been launched"s);
     if (!_error_message.empty())
     {
         ImGuiNotify::change(
@@ -73,8 +83,30 @@ void Task_LaunchVersion::cleanup(bool /* has_been_canceled */)
     }
 }
 
+/// We don't have a handle on the process, so we watch the files that Coollab writes when it starts: its log, and the info folder of the project
+static auto wait_for_first_signal_of_life(std::vector<std::filesystem::path> const& files, std::chrono::seconds timeout) -> bool
+{
+    auto       error_code    = std::error_code{};
+    auto       initial_times = std::vector<std::filesystem::file_time_type>{};
+    auto const deadline      = std::chrono::steady_clock::now() + timeout;
+    for (auto const& file : files)
+        initial_times.push_back(std::filesystem::last_write_time(file, error_code)); // Might not exist yet, in which case its creation is the signal we are waiting for
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            auto const time = std::filesystem::last_write_time(files[i], error_code);
+            if (!error_code && time != initial_times[i])
+                return true;
+        }
+    }
+    return false;
+}
+
 void Task_LaunchVersion::execute()
 {
+    launch_timelines().end_step(_launch_id, "Waiting for the version to be installed");
     auto const* const version = version_manager().find_installed_version(_version_ref, false /*filter_experimental_versions*/);
     if (!version || version->installation_status != InstallationStatus::Installed)
     {
@@ -109,17 +141,59 @@ void Task_LaunchVersion::execute()
         _project_to_open_or_create
     );
 
+    // Opening the project in a Coollab that is already running is much faster than starting a new one
+    if (auto const socket_path = running_instance_socket_path(version->name);
+        socket_path.has_value() && Cool::File::exists(*socket_path))
+    {
+        launch_timelines().begin_step(_launch_id, "Handing the project over to a running Coollab");
+        bool const has_been_handed_over = hand_over_to_running_instance(*socket_path, args, std::chrono::milliseconds{1000}); // Plenty, the instance answers as soon as it has received the arguments, before opening the project
+        launch_timelines().end_step(_launch_id, "Handing the project over to a running Coollab");
+        if (has_been_handed_over)
+        {
+            record_launch_time(version->name);
+            launch_timelines().finish(_launch_id, "Handed over to a running Coollab");
+            Cool::close_application_if_all_tasks_are_done();
+            return;
+        }
+    }
+
+    launch_timelines().begin_step(_launch_id, "Spawning Coollab");
     auto const maybe_error = Cool::spawn_process({
         .executable_absolute_path = executable_path(version->name),
         .command_line_args        = args,
         .working_directory        = exe_path::dir(), // To make sure Coollab will find the DLLs
     });
+    launch_timelines().end_step(_launch_id, "Spawning Coollab");
     if (maybe_error.has_value())
     {
         Cool::Log::internal_warning("Launch", *maybe_error);
         _error_message = fmt::format("{} is corrupted. You should uninstall and reinstall it.", as_string(_version_ref));
         return;
     }
+    record_launch_time(version->name);
+
+    auto outcome = "Coollab has been launched"s;
+    // Only while debugging, because it delays the closing of the launcher
+    if (Launcher::DebugOptions::launch_timeline_window())
+    {
+        launch_timelines().begin_step(_launch_id, "Waiting for a first signal of life from Coollab");
+        auto files_to_watch = std::vector<std::filesystem::path>{Cool::file_logger_path("Coollab")};
+        std::visit(
+            Cool::overloaded{
+                [&](FileToOpen const& file) {
+                    files_to_watch.push_back(Path::projects_info_folder() / Cool::hash_project_path_for_info_folder(path_arg(file.path)) / "path.txt");
+                },
+                [&](FolderToCreateNewProject const&) {
+                    files_to_watch.push_back(Path::projects_info_folder()); // A new info folder gets created in it
+                },
+            },
+            _project_to_open_or_create
+        );
+        bool const is_alive = wait_for_first_signal_of_life(files_to_watch, std::chrono::seconds{30});
+        launch_timelines().end_step(_launch_id, "Waiting for a first signal of life from Coollab");
+        outcome = is_alive ? "Coollab is running" : "No signal of life from Coollab";
+    }
+    launch_timelines().finish(_launch_id, outcome);
 
     Cool::close_application_if_all_tasks_are_done(); // If some installations are still in progress we want to keep the launcher open so that they can finish. And once they are done, if we were to close the launcher it would feel weird for the user that it suddenly closed, so we just keep it open.
 }
\ No newline at end of file
@@ -2,13 +2,14 @@
 #include <ImGuiNotify/ImGuiNotify.hpp>
 #include <reg/src/generate_uuid.hpp>
 #include "Cool/Task/Task.hpp"
+#include "LaunchTimelines.hpp"
 #include "ProjectToOpenOrCreate.hpp"
 #include "VersionRef.hpp"
 
 /// NB: the version must be installed before execute() is called
 class Task_LaunchVersion : public Cool::Task {
 public:
-    explicit Task_LaunchVersion(VersionRef version_ref, ProjectToOpenOrCreate project_to_open_or_create);
+    Task_LaunchVersion(VersionRef version_ref, ProjectToOpenOrCreate project_to_open_or_create, LaunchId launch_id);
 
     auto name() const -> std::string override;
 
@@ -26,4 +27,5 @@ private:
     ProjectToOpenOrCreate       _project_to_open_or_create{};
     ImGuiNotify::NotificationId _notification_id{};
     std::string                 _error_message{""};
+    LaunchId                    _launch_id;
 };
\ No newline at end of file
@@ -0,0 +1,9 @@
+#include "Task_ScanInstalledVersions.hpp"
+#include "installed_versions_index.hpp"
+
+void Task_ScanInstalledVersions::execute()
+{
+    auto installed_versions = scan_installed_versions_folder();
+    auto lock               = std::unique_lock{_incoming_installed_versions->mutex};
+    _incoming_installed_versions->installed_versions = std::move(installed_versions);
+}
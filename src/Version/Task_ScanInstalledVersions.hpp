@@ -0,0 +1,30 @@
+#pragma once
+#include <mutex>
+#include "Cool/Task/Task.hpp"
+#include "VersionName.hpp"
+
+/// Where the Task_ScanInstalledVersions puts the versions it finds, until the VersionManager picks them up on the main thread
+struct IncomingInstalledVersions {
+    std::mutex                              mutex{};
+    std::optional<std::vector<VersionName>> installed_versions{}; // Set once the scan is done
+};
+
+/// Rebuilds the list of installed versions when the index file is missing or outdated
+class Task_ScanInstalledVersions : public Cool::Task {
+public:
+    explicit Task_ScanInstalledVersions(std::shared_ptr<IncomingInstalledVersions> incoming_installed_versions)
+        : _incoming_installed_versions{std::move(incoming_installed_versions)}
+    {}
+
+    auto name() const -> std::string override { return "Looking for the versions that are installed on this computer"; }
+
+private:
+    void execute() override;
+
+    auto is_quick_task() const -> bool override { return false; }
+    auto needs_user_confirmation_to_cancel_when_closing_app() const -> bool override { return false; }
+    void cancel() override {}
+
+private:
+    std::shared_ptr<IncomingInstalledVersions> _incoming_installed_versions;
+};
@@ -0,0 +1,28 @@
+#include "Task_UninstallVersion.hpp"
+#include "Cool/File/File.h"
+
+void Task_UninstallVersion::execute()
+{
+    TaskWithProgressBar::change_notification_when_execution_starts();
+
+    auto files      = std::vector<std::filesystem::path>{};
+    auto error_code = std::error_code{};
+    for (auto it = std::filesystem::recursive_directory_iterator{_folder_in_trash, error_code}; !error_code && it != std::filesystem::recursive_directory_iterator{}; it.increment(error_code))
+    {
+        if (cancel_requested())
+            return;
+        if (!it->is_directory(error_code))
+            files.push_back(it->path());
+    }
+
+    // Delete files one by one so that we can report progress and stop as soon as we get canceled
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        if (cancel_requested())
+            return;
+        std::filesystem::remove(files[i], error_code);
+        set_progress(static_cast<float>(i + 1) / static_cast<float>(files.size()));
+    }
+
+    Cool::File::remove_folder(_folder_in_trash); // Only empty folders are left, this is quick
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "Cool/Task/TaskWithProgressBar.hpp"
+
+/// Deletes the files of a version that has already been moved to the trash folder (see VersionManager::uninstall())
+/// If it gets canceled, the remaining files will be deleted the next time the launcher starts
+class Task_UninstallVersion : public Cool::TaskWithProgressBar {
+public:
+    Task_UninstallVersion(std::string version_label, std::filesystem::path folder_in_trash)
+        : _version_label{std::move(version_label)}
+        , _folder_in_trash{std::move(folder_in_trash)}
+    {}
+
+    auto name() const -> std::string override { return fmt::format("Uninstalling {}", _version_label); }
+
+private:
+    void execute() override;
+
+    auto needs_user_confirmation_to_cancel_when_closing_app() const -> bool override { return false; }
+
+private:
+    std::string           _version_label;
+    std::filesystem::path _folder_in_trash;
+};
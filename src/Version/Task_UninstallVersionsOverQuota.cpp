@@ -0,0 +1,32 @@
+#include "Task_UninstallVersionsOverQuota.hpp"
+#include "installation_path.hpp"
+#include "version_usage.hpp"
+
+void Task_UninstallVersionsOverQuota::execute()
+{
+    auto usages = std::vector<VersionUsage>{};
+    for (auto const& version_name : _installed_versions)
+    {
+        if (_cancel.load())
+            return;
+
+        auto const size = size_on_disk(installation_path(version_name));
+        {
+            auto lock = std::unique_lock{_incoming_disk_usage->mutex};
+            _incoming_disk_usage->sizes_on_disk.emplace_back(version_name, size); // So that the sizes show up in the UI one by one, even when there are many versions
+        }
+        usages.push_back(VersionUsage{
+            .name               = version_name,
+            .size_on_disk       = size,
+            .last_launch_time   = last_launch_time(version_name),
+            .can_be_uninstalled = std::find(_protected_versions.begin(), _protected_versions.end(), version_name) == _protected_versions.end(),
+        });
+    }
+
+    if (!_quota_in_bytes.has_value() || _cancel.load())
+        return;
+
+    auto versions_to_uninstall = versions_to_uninstall_to_respect_quota(std::move(usages), *_quota_in_bytes);
+    auto lock                  = std::unique_lock{_incoming_disk_usage->mutex};
+    _incoming_disk_usage->versions_to_uninstall.insert(_incoming_disk_usage->versions_to_uninstall.end(), versions_to_uninstall.begin(), versions_to_uninstall.end());
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <mutex>
+#include "Cool/Task/Task.hpp"
+#include "VersionName.hpp"
+
+/// Where the Task_UninstallVersionsOverQuota puts its results, until the VersionManager applies them on the main thread
+struct IncomingDiskUsage {
+    std::mutex                                     mutex{};
+    std::vector<std::pair<VersionName, uintmax_t>> sizes_on_disk{};
+    std::vector<VersionName>                       versions_to_uninstall{};
+};
+
+/// Computes the size on disk of all the installed versions, and if a quota is set, finds the least recently used ones that need to be uninstalled to get under the quota
+class Task_UninstallVersionsOverQuota : public Cool::Task {
+public:
+    Task_UninstallVersionsOverQuota(std::shared_ptr<IncomingDiskUsage> incoming_disk_usage, std::vector<VersionName> installed_versions, std::vector<VersionName> protected_versions, std::optional<uintmax_t> quota_in_bytes)
+        : _incoming_disk_usage{std::move(incoming_disk_usage)}
+        , _installed_versions{std::move(installed_versions)}
+        , _protected_versions{std::move(protected_versions)}
+        , _quota_in_bytes{quota_in_bytes}
+    {}
+
+    auto name() const -> std::string override { return "Computing the disk space used by the installed versions"; }
+
+private:
+    void execute() override;
+
+    auto is_quick_task() const -> bool override { return false; }
+    auto needs_user_confirmation_to_cancel_when_closing_app() const -> bool override { return false; }
+    void cancel() override { _cancel.store(true); }
+
+private:
+    std::shared_ptr<IncomingDiskUsage> _incoming_disk_usage;
+    std::vector<VersionName>           _installed_versions;
+    std::vector<VersionName>           _protected_versions; // Versions that must never be uninstalled automatically
+    std::optional<uintmax_t>           _quota_in_bytes;
+    std::atomic<bool>                  _cancel{false};
+};
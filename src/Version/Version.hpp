@@ -12,6 +12,7 @@ struct Version {
     InstallationStatus         installation_status{};
     std::optional<std::string> download_url{};
     std::optional<std::string> changelog_url{};
+    std::optional<uintmax_t>   size_on_disk{}; // Computed in the background, only known for installed versions
 
     friend auto operator<=>(Version const& a, Version const& b) { return b.name <=> a.name; } // Compare b to a and not the other way around because when sorting or vector of Version, we want the latest to be at the front
     friend auto operator==(Version const& a, Version const& b) -> bool { return a.name == b.name; }
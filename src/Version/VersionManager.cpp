@@ -13,86 +13,189 @@
 #include "Cool/Task/TaskManager.hpp"
 #include "Cool/Task/WaitToExecuteTask.hpp"
 #include "Cool/Utils/overloaded.hpp"
+#include "DebugOptions/DebugOptions.hpp"
 #include "LauncherSettings.hpp"
 #include "Path.hpp"
 #include "Status.hpp"
+#include "StatusSignal.hpp"
 #include "Task_FetchListOfVersions.hpp"
 #include "Task_InstallVersion.hpp"
 #include "Task_LaunchVersion.hpp"
+#include "Task_ScanInstalledVersions.hpp"
+#include "Task_UninstallVersion.hpp"
+#include "Task_UninstallVersionsOverQuota.hpp"
+#include "UpgradeDecisionsGeneration.hpp"
 #include "Version.hpp"
 #include "Version/installation_path.hpp"
 #include "VersionName.hpp"
 #include "VersionRef.hpp"
 #include "fmt/format.h"
 #include "installation_path.hpp"
+#include "installed_versions_index.hpp"
+#include "version_usage.hpp"
 
-static auto get_all_locally_installed_versions() -> std::vector<Version>
+// TODO(Launcher) Make VersionManager thread safe
+
+static void empty_versions_trash()
 {
-    auto versions = std::vector<Version>{};
-    try
+    auto error_code = std::error_code{};
+    for (auto it = std::filesystem::directory_iterator{Path::versions_trash_folder(), error_code}; !error_code && it != std::filesystem::directory_iterator{}; it.increment(error_code))
     {
-        for (auto const& entry : std::filesystem::directory_iterator{Path::installed_versions_folder()})
-        {
-            try
-            {
-                if (!entry.is_directory())
-                    continue;
-                auto const name = entry.path().filename().string(); // Use filename() and not stem(), because stem() would stop at the first dot (e.g. "folder/19.0.3" would become "19" instead of "19.0.3")
-                if (std::none_of(versions.begin(), versions.end(), [&](Version const& version) {
-                        return version.name.as_string() == name;
-                    }))
-                {
-                    auto const version_name = VersionName::from(name);
-                    if (version_name.has_value())
-                        versions.emplace_back(Version{*version_name, InstallationStatus::Installed});
-                }
-            }
-            catch (std::exception const& e)
-            {
-                Cool::Log::internal_error("Get all locally installed versions", e.what());
-            }
-        }
+        auto const folder_name = it->path().filename().string();
+        auto const version     = folder_name.substr(0, folder_name.rfind(' ')); // Remove the timestamp that uninstall() appended to the version name
+        Cool::task_manager().submit(std::make_shared<Task_UninstallVersion>(version, it->path()));
+    }
+}
+
+VersionManager::VersionManager()
+{
+    auto const installed_versions = read_installed_versions_index();
+    if (installed_versions.has_value())
+    {
+        for (auto const& version_name : *installed_versions)
+            _versions.push_back(Version{version_name, InstallationStatus::Installed});
+        std::sort(_versions.begin(), _versions.end());
+        _scan_of_installed_versions_signal->signal(Status::Completed);
     }
-    catch (std::exception const& e)
+    else
     {
-        Cool::Log::internal_error("Get all locally installed versions", e.what());
+        // The index is outdated, rebuild it in the background so that we don't block the first frame
+        Cool::task_manager().submit(std::make_shared<Task_ScanInstalledVersions>(_incoming_installed_versions));
     }
-    std::sort(versions.begin(), versions.end());
-    return versions;
+
+    // Finish deleting the versions that were being uninstalled when the launcher was last closed
+    empty_versions_trash();
+
+    // TODO(Launcher) make sure to not send a request if we know which project to launch, and we already have that version, to save on the number of requests allowed by Github
+    // Wait for the scan because once the list is fetched we might auto-install the latest version, and we need to know if it is already installed
+    Cool::task_manager().submit(after(_scan_of_installed_versions_signal), std::make_shared<Task_FetchListOfVersions>());
 }
 
-// TODO(Launcher) Make VersionManager thread safe
+void VersionManager::receive_installed_versions()
+{
+    auto installed_versions = std::optional<std::vector<VersionName>>{};
+    {
+        auto lock = std::unique_lock{_incoming_installed_versions->mutex};
+        std::swap(installed_versions, _incoming_installed_versions->installed_versions);
+    }
+    if (installed_versions.has_value())
+        on_finished_scanning_installed_versions(*installed_versions);
+}
 
-VersionManager::VersionManager()
-    : _versions{get_all_locally_installed_versions()}
+void VersionManager::on_finished_scanning_installed_versions(std::vector<VersionName> const& installed_versions)
 {
-    // TODO(Launcher) make sure to not send a request if we know which project to launch, and we already have that version, to save on the number of requests allowed by Github
-    Cool::task_manager().submit(std::make_shared<Task_FetchListOfVersions>());
+    for (auto const& version_name : installed_versions)
+    {
+        with_version_found_or_created(version_name, false /*filter_experimental_versions*/, [&](Version& version) {
+            if (version.installation_status == InstallationStatus::NotInstalled)
+                version.installation_status = InstallationStatus::Installed;
+        });
+    }
+    write_installed_versions_index(installed_versions);
+    _scan_of_installed_versions_signal->signal(Status::Completed);
 }
 
-class WaitToExecuteTask_HasFetchedListOfVersions : public Cool::WaitToExecuteTask {
-public:
-    auto wants_to_execute() -> bool override { return version_manager().status_of_fetch_list_of_versions() == Status::Completed; }
-    auto wants_to_cancel() -> bool override { return version_manager().status_of_fetch_list_of_versions() == Status::Canceled; }
-};
+void VersionManager::update()
+{
+    receive_installed_versions();
+    receive_disk_usage();
+    if (_installed_versions_index_is_outdated.exchange(false))
+        update_installed_versions_index();
+}
+
+auto VersionManager::needs_to_check_disk_quota() -> bool
+{
+    if (_scan_of_installed_versions_signal->status() != Status::Completed)
+        return false; // We don't know yet which versions are installed
+    return _needs_to_check_disk_quota.exchange(false);
+}
 
-static auto after_has_fetched_list_of_versions() -> std::shared_ptr<Cool::WaitToExecuteTask>
+void VersionManager::check_disk_quota(std::vector<VersionName> const& versions_used_by_projects)
 {
-    return std::make_shared<WaitToExecuteTask_HasFetchedListOfVersions>();
+    auto installed_versions = std::vector<VersionName>{};
+    for (auto const& version : _versions)
+    {
+        if (version.installation_status == InstallationStatus::Installed)
+            installed_versions.push_back(version.name);
+    }
+
+    auto protected_versions = versions_used_by_projects;
+    if (auto const* const latest_installed_version = latest_installed_version_no_locking(true /*filter_experimental_versions*/))
+        protected_versions.push_back(latest_installed_version->name); // Used by default when creating a new project
+
+    Cool::task_manager().submit(std::make_shared<Task_UninstallVersionsOverQuota>(
+        _incoming_disk_usage,
+        std::move(installed_versions),
+        std::move(protected_versions),
+        launcher_settings().disk_quota_for_versions_in_bytes()
+    ));
+}
+
+void VersionManager::receive_disk_usage()
+{
+    auto sizes_on_disk         = std::vector<std::pair<VersionName, uintmax_t>>{};
+    auto versions_to_uninstall = std::vector<VersionName>{};
+    {
+        auto lock = std::unique_lock{_incoming_disk_usage->mutex};
+        std::swap(sizes_on_disk, _incoming_disk_usage->sizes_on_disk);
+        std::swap(versions_to_uninstall, _incoming_disk_usage->versions_to_uninstall);
+    }
+    for (auto const& [name, size] : sizes_on_disk)
+        set_size_on_disk(name, size);
+    for (auto const& name : versions_to_uninstall)
+        uninstall_to_respect_disk_quota(name);
+}
+
+void VersionManager::set_size_on_disk(VersionName const& name, uintmax_t size)
+{
+    with_version_found(name, false /*filter_experimental_versions*/, [&](Version& version) {
+        version.size_on_disk = size;
+    });
+}
+
+void VersionManager::uninstall_to_respect_disk_quota(VersionName const& name)
+{
+    with_version_found(name, false /*filter_experimental_versions*/, [&](Version& version) {
+        if (version.installation_status != InstallationStatus::Installed)
+            return;
+        if (Launcher::DebugOptions::log_when_uninstalling_versions_automatically())
+        {
+            Cool::Log::internal_info(
+                "Disk quota",
+                fmt::format("Uninstalling {} ({} MB), which hasn't been launched for {} days", name.as_string(), version.size_on_disk.value_or(0) / 1'000'000, std::chrono::duration_cast<std::chrono::hours>(std::chrono::system_clock::now() - last_launch_time(name)).count() / 24)
+            );
+        }
+        uninstall(version);
+        ImGuiNotify::send({
+            .type    = ImGuiNotify::Type::Info,
+            .title   = fmt::format("Uninstalled {}", name.as_string()),
+            .content = "To stay under the disk space limit set in the settings, we uninstalled this version because you haven't used it in a while. No project needed it.",
+        });
+    });
+}
+
+void VersionManager::update_installed_versions_index() const
+{
+    auto installed_versions = std::vector<VersionName>{};
+    for (auto const& version : _versions)
+    {
+        if (version.installation_status == InstallationStatus::Installed)
+            installed_versions.push_back(version.name);
+    }
+    write_installed_versions_index(installed_versions);
 }
 
 auto VersionManager::after_version_installed(VersionRef const& version_ref) -> std::shared_ptr<Cool::WaitToExecuteTask>
 {
     auto const after_latest_version_installed = [&]() {
-        if (_status_of_fetch_list_of_versions.load() == Status::Completed)
+        if (status_of_fetch_list_of_versions() == Status::Completed)
         {
             auto const* const latest_version = latest_version_with_download_url_no_locking(true /*filter_experimental_versions*/);
             if (!latest_version)
             {
                 // TODO(Launcher) error, should not happen
             }
-            auto const install_task = get_install_task_or_create_and_submit_it(latest_version->name);
-            return after(install_task);
+            return after_installation_of(latest_version->name);
         }
         else if (has_at_least_one_version_installed(true /*filter_experimental_versions*/))
         {
@@ -102,7 +205,7 @@ auto VersionManager::after_version_installed(VersionRef const& version_ref) -> s
         else
         {
             auto const task_install_latest_version = std::make_shared<Task_InstallVersion>(); // TODO(Launcher) When this task starts executing, it should register itself as an installing task to the version manager. Because since we don't yet know which version it will install we can't put it in the _install_tasks list immediately
-            Cool::task_manager().submit(after_has_fetched_list_of_versions(), task_install_latest_version);
+            Cool::task_manager().submit(after(_fetch_list_of_versions_signal), task_install_latest_version);
             return after(task_install_latest_version);
         }
     };
@@ -125,32 +228,43 @@ auto VersionManager::after_version_installed(VersionRef const& version_ref) -> s
             [&](VersionName const& version_name) -> std::shared_ptr<Cool::WaitToExecuteTask> {
                 if (is_installed(version_name, false /*filter_experimental_versions*/))
                     return after_nothing();
-                auto const install_task = get_install_task_or_create_and_submit_it(version_name);
-                return after(install_task);
+                return after_installation_of(version_name);
             }
         },
         version_ref
     );
 }
 
-auto VersionManager::get_install_task_or_create_and_submit_it(VersionName const& version_name) -> std::shared_ptr<Cool::Task>
+auto VersionManager::after_installation_of(VersionName const& version_name) -> std::shared_ptr<Cool::WaitToExecuteTask>
 {
-    auto const it = _install_tasks.find(version_name);
-    if (it != _install_tasks.end())
+    if (is_installed(version_name, false /*filter_experimental_versions*/))
+        return after_nothing();
+    return after(get_install_task_or_create_and_submit_it(version_name).signal);
+}
+
+auto VersionManager::get_install_task_or_create_and_submit_it(VersionName const& version_name) -> InstallTask
+{
+    auto       lock = std::unique_lock{_install_tasks_mutex};
+    auto const it   = _install_tasks.find(version_name);
+    if (it != _install_tasks.end() && it->second.signal->status() == Status::Waiting)
         return it->second;
 
-    auto const install_task = std::make_shared<Task_InstallVersion>(version_name);
-    Cool::task_manager().submit(after_has_fetched_list_of_versions(), install_task);
-    _install_tasks.insert(std::make_pair(version_name, install_task));
-    return install_task;
+    // The task signals it itself when it finishes, so that it never needs to touch _install_tasks from its thread
+    auto const signal       = std::make_shared<StatusSignal>();
+    auto const install_task = std::make_shared<Task_InstallVersion>(version_name, signal);
+    _install_tasks.insert_or_assign(version_name, InstallTask{.task = install_task, .signal = signal});
+    Cool::task_manager().submit(after(_fetch_list_of_versions_signal), install_task);
+    return {.task = install_task, .signal = signal};
 }
 
 auto VersionManager::get_latest_installing_version_if_any() const -> std::shared_ptr<Cool::Task>
 {
+    auto lock     = std::unique_lock{_install_tasks_mutex};
     auto res      = std::shared_ptr<Cool::Task>{};
     auto ver_name = std::optional<VersionName>{};
-    for (auto const& [version_name, task] : _install_tasks)
+    for (auto const& [version_name, install_task] : _install_tasks)
     {
+        auto const& task = install_task.task;
         if (task->has_been_canceled() || task->has_been_executed())
             continue;
         if (!ver_name || *ver_name < version_name)
@@ -162,11 +276,50 @@ auto VersionManager::get_latest_installing_version_if_any() const -> std::shared
     return res;
 }
 
-void VersionManager::install_ifn_and_launch(VersionRef const& version_ref, ProjectToOpenOrCreate project_to_open_or_create)
+/// Used when we are asked to launch a project before we know which versions are installed
+class Task_InstallIfnAndLaunch : public Cool::Task {
+public:
+    Task_InstallIfnAndLaunch(VersionRef version_ref, ProjectToOpenOrCreate project_to_open_or_create, LaunchId launch_id)
+        : _version_ref{std::move(version_ref)}
+        , _project_to_open_or_create{std::move(project_to_open_or_create)}
+        , _launch_id{launch_id}
+    {}
+
+    auto name() const -> std::string override { return "Preparing the launch of Coollab"; }
+
+private:
+    void execute() override
+    {
+        launch_timelines().end_step(_launch_id, "Waiting for the scan of the installed versions");
+        version_manager().install_ifn_and_launch(_version_ref, _project_to_open_or_create, _launch_id);
+    }
+
+    auto is_quick_task() const -> bool override { return true; }
+    void cancel() override {}
+    auto needs_user_confirmation_to_cancel_when_closing_app() const -> bool override { return false; }
+
+private:
+    VersionRef            _version_ref;
+    ProjectToOpenOrCreate _project_to_open_or_create;
+    LaunchId              _launch_id;
+};
+
+void VersionManager::install_ifn_and_launch(VersionRef const& version_ref, ProjectToOpenOrCreate project_to_open_or_create, LaunchId launch_id)
 {
+    if (_scan_of_installed_versions_signal->status() != Status::Completed)
+    {
+        // We can't know yet if we need to install the version, so we decide later
+        launch_timelines().begin_step(launch_id, "Waiting for the scan of the installed versions");
+        Cool::task_manager().submit(after(_scan_of_installed_versions_signal), std::make_shared<Task_InstallIfnAndLaunch>(version_ref, std::move(project_to_open_or_create), launch_id));
+        return;
+    }
+
+    launch_timelines().begin_step(launch_id, "Resolving the dependencies");
+    auto wait = after_version_installed(version_ref);
+    launch_timelines().end_step(launch_id, "Resolving the dependencies");
     Cool::task_manager().submit(
-        after_version_installed(version_ref),
-        std::make_shared<Task_LaunchVersion>(version_ref, std::move(project_to_open_or_create))
+        std::move(wait),
+        std::make_shared<Task_LaunchVersion>(version_ref, std::move(project_to_open_or_create), launch_id)
     );
 }
 
@@ -177,6 +330,13 @@ void VersionManager::install_latest_version(bool filter_experimental_versions)
         install(*latest_version);
 }
 
+void VersionManager::install_ifn(VersionName const& version_name)
+{
+    auto const* const version = find(version_name, false /*filter_experimental_versions*/);
+    if (version && version->installation_status == InstallationStatus::NotInstalled)
+        install(*version);
+}
+
 void VersionManager::install(Version const& version)
 {
     if (version.installation_status != InstallationStatus::NotInstalled)
@@ -194,8 +354,27 @@ void VersionManager::uninstall(Version& version)
         assert(false);
         return;
     }
-    Cool::File::remove_folder(installation_path(version.name));
+
+    // Move the folder to the trash first, which is instantaneous, so that the UI can update immediately. The files will then be deleted in the background
+    auto const folder_in_trash = Path::versions_trash_folder() / fmt::format("{} {}", version.name.as_string(), std::chrono::system_clock::now().time_since_epoch().count());
+    auto       error_code      = std::error_code{};
+    if (Cool::File::create_folders_if_they_dont_exist(Path::versions_trash_folder()))
+        std::filesystem::rename(installation_path(version.name), folder_in_trash, error_code);
+    if (error_code || !Cool::File::exists(folder_in_trash))
+    {
+        Cool::Log::internal_warning("Uninstall", error_code.message());
+        ImGuiNotify::send({
+            .type    = ImGuiNotify::Type::Error,
+            .title   = fmt::format("Failed to uninstall {}", version.name.as_string()),
+            .content = "Make sure this version is not currently running, and try again",
+        });
+        return;
+    }
+
     version.installation_status = InstallationStatus::NotInstalled;
+    version.size_on_disk.reset();
+    update_installed_versions_index();
+    Cool::task_manager().submit(std::make_shared<Task_UninstallVersion>(version.name.as_string(), folder_in_trash));
 }
 
 auto VersionManager::find(VersionName const& name, bool filter_experimental_versions) const -> Version const*
@@ -270,6 +449,7 @@ void VersionManager::with_version_found_or_created(VersionName const& name, bool
         auto const new_version = Version{name, InstallationStatus::NotInstalled};
         // Make sure to keep the vector sorted:
         version = &*_versions.insert(std::lower_bound(_versions.begin(), _versions.end(), new_version), new_version);
+        upgrade_decisions_generation().bump(); // Projects might be able to upgrade to this new version
     }
 
     callback(*version);
@@ -308,15 +488,15 @@ void VersionManager::set_installation_status(VersionName const& name, Installati
     });
     if (installation_status == InstallationStatus::Installed || installation_status == InstallationStatus::NotInstalled)
     {
-        auto const it = _install_tasks.find(name);
-        if (it != _install_tasks.end())
-            _install_tasks.erase(it);
+        _installed_versions_index_is_outdated.store(true); // Called from the install task's thread, so we don't write the index here
+        if (installation_status == InstallationStatus::Installed)
+            request_disk_quota_check();
     }
 }
 
 void VersionManager::on_finished_fetching_list_of_versions()
 {
-    _status_of_fetch_list_of_versions.store(Status::Completed);
+    _fetch_list_of_versions_signal->signal(Status::Completed);
 
     if (launcher_settings().automatically_install_latest_version)
         install_latest_version(true /*filter_experimental_versions*/);
@@ -330,6 +510,12 @@ auto VersionManager::is_installed(VersionName const& version_name, bool filter_e
     return version->installation_status == InstallationStatus::Installed;
 }
 
+auto VersionManager::is_not_installed(VersionName const& version_name) const -> bool
+{
+    auto const* const version = find(version_name, false /*filter_experimental_versions*/);
+    return version && version->installation_status == InstallationStatus::NotInstalled;
+}
+
 auto VersionManager::latest_version(bool filter_experimental_versions) const -> Version const*
 {
     // auto lock = std::unique_lock{_mutex};
@@ -379,7 +565,10 @@ void VersionManager::imgui_manage_versions()
     {
         ImGui::PushID(&version);
         ImGui::BeginGroup();
-        ImGui::SeparatorText(version.name.as_string().c_str());
+        auto const title = version.size_on_disk.has_value() && version.installation_status == InstallationStatus::Installed
+                               ? fmt::format("{} ({} MB)", version.name.as_string(), *version.size_on_disk / 1'000'000)
+                               : version.name.as_string();
+        ImGui::SeparatorText(title.c_str());
         if (version.changelog_url.has_value())
         {
             if (Cool::ImGuiExtras::button_with_text_icon(ICOMOON_INFO))
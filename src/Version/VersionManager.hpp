@@ -1,12 +1,17 @@
 #pragma once
 #include <ImGuiNotify/ImGuiNotify.hpp>
 #include <map>
+#include <mutex>
 #include <tl/expected.hpp>
 #include "Cool/Task/Task.hpp"
 #include "Cool/Task/WaitToExecuteTask.hpp"
+#include "LaunchTimelines.hpp"
 #include "LauncherSettings.hpp"
 #include "ProjectToOpenOrCreate.hpp"
 #include "Status.hpp"
+#include "StatusSignal.hpp"
+#include "Task_ScanInstalledVersions.hpp"
+#include "Task_UninstallVersionsOverQuota.hpp"
 #include "Version.hpp"
 #include "VersionName.hpp"
 #include "VersionRef.hpp"
@@ -16,8 +21,13 @@ class VersionManager {
 public:
     VersionManager();
 
-    void install_ifn_and_launch(VersionRef const&, ProjectToOpenOrCreate);
+    /// Applies the results of the background tasks. Must be called every frame, from the main thread
+    void update();
+
+    void install_ifn_and_launch(VersionRef const&, ProjectToOpenOrCreate, LaunchId);
     void install_latest_version(bool filter_experimental_versions);
+    /// Does nothing if the version is already installed or being installed
+    void install_ifn(VersionName const&);
 
     void imgui_manage_versions();
     void imgui_versions_dropdown(VersionRef&);
@@ -25,12 +35,24 @@ public:
     auto find(VersionName const& name, bool filter_experimental_versions) const -> Version const*;
     auto find_installed_version(VersionRef const&, bool filter_experimental_versions) const -> Version const*;
     auto latest_version(bool filter_experimental_versions) const -> Version const*;
-    auto status_of_fetch_list_of_versions() const -> Status { return _status_of_fetch_list_of_versions.load(); }
+    auto status_of_fetch_list_of_versions() const -> Status { return _fetch_list_of_versions_signal->status(); }
     auto is_installed(VersionName const&, bool filter_experimental_versions) const -> bool;
+    auto is_not_installed(VersionName const&) const -> bool;
 
     auto label(VersionRef const&, bool filter_experimental_versions) const -> std::string;
 
+    /// Returns true once after each event that might have changed the disk space used by the versions (startup, new installation, change of quota)
+    auto needs_to_check_disk_quota() -> bool;
+    void request_disk_quota_check() { _needs_to_check_disk_quota.store(true); }
+    /// Computes the size of all installed versions in the background, and uninstalls the least recently launched ones if we are over the quota set in the LauncherSettings
+    void check_disk_quota(std::vector<VersionName> const& versions_used_by_projects);
+
 private:
+    struct InstallTask {
+        std::shared_ptr<Cool::Task>   task{};
+        std::shared_ptr<StatusSignal> signal{}; // Signaled by the task itself when it finishes, so that the waiting tasks don't need to query the VersionManager
+    };
+
     auto find_no_locking(VersionName const&, bool filter_experimental_versions) -> Version*;
     auto find_no_locking(VersionName const&, bool filter_experimental_versions) const -> Version const*;
     auto latest_version_no_locking(bool filter_experimental_versions) const -> Version const*;
@@ -44,9 +66,11 @@ private:
 
     void install(Version const&);
     void uninstall(Version&);
+    void update_installed_versions_index() const;
 
     auto after_version_installed(VersionRef const& version_ref) -> std::shared_ptr<Cool::WaitToExecuteTask>;
-    auto get_install_task_or_create_and_submit_it(VersionName const&) -> std::shared_ptr<Cool::Task>;
+    auto after_installation_of(VersionName const&) -> std::shared_ptr<Cool::WaitToExecuteTask>;
+    auto get_install_task_or_create_and_submit_it(VersionName const&) -> InstallTask;
 
     auto versions(bool filter_experimental_versions) const
     {
@@ -65,13 +89,24 @@ private:
     void set_changelog_url(VersionName const&, std::string changelog_url);
     void set_installation_status(VersionName const&, InstallationStatus);
     void on_finished_fetching_list_of_versions();
+    void receive_installed_versions();
+    void on_finished_scanning_installed_versions(std::vector<VersionName> const&);
+    void receive_disk_usage();
+    void set_size_on_disk(VersionName const&, uintmax_t size);
+    void uninstall_to_respect_disk_quota(VersionName const&);
 
 private:
     std::vector<Version> _versions{}; // Sorted, from latest to oldest version
     // mutable std::shared_mutex _mutex{};
 
-    std::atomic<Status>                                _status_of_fetch_list_of_versions{Status::Waiting};
-    std::map<VersionName, std::shared_ptr<Cool::Task>> _install_tasks{};
+    std::shared_ptr<StatusSignal>              _scan_of_installed_versions_signal{std::make_shared<StatusSignal>()};
+    std::shared_ptr<StatusSignal>              _fetch_list_of_versions_signal{std::make_shared<StatusSignal>()};
+    std::map<VersionName, InstallTask>         _install_tasks{};       // The finished ones stay until the version needs to be installed again
+    mutable std::mutex                         _install_tasks_mutex{}; // Installations are requested from the main thread, but also from the tasks that fetch the list of versions and prepare the launches
+    std::atomic<bool>                          _needs_to_check_disk_quota{true};
+    std::atomic<bool>                          _installed_versions_index_is_outdated{false}; // Set by the install tasks, so that update() rewrites the index on the main thread
+    std::shared_ptr<IncomingInstalledVersions> _incoming_installed_versions{std::make_shared<IncomingInstalledVersions>()};
+    std::shared_ptr<IncomingDiskUsage>         _incoming_disk_usage{std::make_shared<IncomingDiskUsage>()};
 };
 
 inline auto version_manager() -> VersionManager&
@@ -0,0 +1,229 @@
+#include "extract_appimage.hpp"
+#include "Cool/File/File.h"
+#if defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <array>
+#endif
+
+auto extract_appimage(std::filesystem::path const& appimage, std::filesystem::path const& destination_folder, std::function<bool()> const& wants_to_cancel) -> tl::expected<void, std::string>
+{
+#if defined(__linux__)
+    auto const working_folder = destination_folder.parent_path();
+    auto const extracted      = working_folder / "squashfs-root"; // The AppImage runtime always extracts in this folder, we can't choose its name
+    auto       error_code     = std::error_code{};
+    std::filesystem::remove_all(extracted, error_code); // Leftover of an extraction that got interrupted
+
+    auto stderr_pipe = std::array<int, 2>{};
+    if (pipe2(stderr_pipe.data(), O_CLOEXEC) != 0)
+        return tl::make_unexpected("Failed to open command pipe"s);
+
+    // Everything the child needs is prepared before forking, because the child can only call async-signal-safe functions
+    auto       working_folder_string = working_folder.string();
+    auto       appimage_string       = appimage.string();
+    auto       extract_flag          = "--appimage-extract"s;
+    char*      argv[]                = {appimage_string.data(), extract_flag.data(), nullptr}; // NOLINT(*avoid-c-arrays)
+    auto const pid                   = fork();
+    if (pid == -1)
+    {
+        close(stderr_pipe[0]);
+        close(stderr_pipe[1]);
+        return tl::make_unexpected("Failed to start the extraction"s);
+    }
+    if (pid == 0)
+    {
+        setpgid(0, 0); // Its own process group, so that cancelling also kills the processes it might start
+        int const dev_null = open("/dev/null", O_WRONLY | O_CLOEXEC);
+        // Keep only stderr, the runtime prints the name of every file it extracts on stdout
+        if (chdir(working_folder_string.c_str()) != 0 || dev_null == -1 || dup2(dev_null, STDOUT_FILENO) == -1 || dup2(stderr_pipe[1], STDERR_FILENO) == -1)
+            _exit(127);
+        execv(appimage_string.c_str(), argv);
+        _exit(127);
+    }
+    setpgid(pid, 0); // Also from the parent, so that the group exists even if we cancel before the child has had time to create it
+    close(stderr_pipe[1]);
+
+    // Polls instead of blocking on the pipe, so that the user can cancel the installation in the middle of the extraction
+    auto error_message = ""s;
+    bool has_canceled{false};
+    while (true)
+    {
+        if (wants_to_cancel())
+        {
+            kill(-pid, SIGKILL);
+            has_canceled = true;
+            break;
+        }
+        auto fds = pollfd{.fd = stderr_pipe[0], .events = POLLIN, .revents = 0};
+        if (poll(&fds, 1, 100) <= 0)
+            continue;
+        auto       buffer = std::array<char, 128>{};
+        auto const res    = read(stderr_pipe[0], buffer.data(), buffer.size());
+        if (res == -1 && errno == EINTR)
+            continue;
+        if (res <= 0)
+            break; // The child has exited, or closed its stderr
+        error_message.append(buffer.data(), static_cast<size_t>(res));
+    }
+    close(stderr_pipe[0]);
+    int status{};
+    while (waitpid(pid, &status, 0) == -1 && errno == EINTR)
+    {}
+
+    if (has_canceled)
+    {
+        std::filesystem::remove_all(extracted, error_code);
+        return tl::make_unexpected("The extraction has been canceled"s);
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || !Cool::File::exists(extracted / "AppRun"))
+    {
+        std::filesystem::remove_all(extracted, error_code);
+        return tl::make_unexpected(error_message.empty() ? "The AppImage didn't extract anything"s : error_message);
+    }
+
+    // Only now that everything has been extracted, so that we never launch an AppRun whose files are not all there yet
+    std::filesystem::rename(extracted, destination_folder, error_code);
+    if (error_code)
+    {
+        auto const message = error_code.message();
+        std::filesystem::remove_all(extracted, error_code);
+        return tl::make_unexpected(message);
+    }
+    return {};
+#else
+    std::ignore = appimage;
+    std::ignore = destination_folder;
+    std::ignore = wants_to_cancel;
+    return tl::make_unexpected("AppImages only exist on Linux"s);
+#endif
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS) && defined(__linux__)
+#include <spawn.h>
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include "Cool/Log/file_logger_path.hpp"
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+/// A shell script that behaves like the AppImage runtime when given --appimage-extract
+static void write_fake_appimage(std::filesystem::path const& path, std::string_view extraction_commands)
+{
+    std::ofstream{path} << fmt::format("#!/bin/sh\nif [ \"$1\" = \"--appimage-extract\" ]; then\n{}\nfi\n", extraction_commands);
+    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+}
+
+static auto never_cancel() -> bool
+{
+    return false;
+}
+
+TEST_CASE("Extracting an AppImage")
+{
+    auto const folder      = TemporaryFolder{"extract_appimage - it's a version"};
+    auto const appimage    = folder / "Coollab.AppImage";
+    auto const destination = folder / "Coollab.AppDir";
+
+    SUBCASE("Failure halfway through")
+    {
+        write_fake_appimage(appimage, "mkdir -p squashfs-root && echo '#!/bin/sh' > squashfs-root/AppRun && echo 'No space left on device' >&2 && exit 1");
+        auto const res = extract_appimage(appimage, destination, never_cancel);
+        REQUIRE(!res.has_value());
+        CHECK(res.error() == "No space left on device\n");
+        CHECK(!std::filesystem::exists(destination));
+        CHECK(!std::filesystem::exists(folder / "squashfs-root"));
+    }
+    SUBCASE("Not an AppImage")
+    {
+        write_fake_appimage(appimage, "true");
+        CHECK(!extract_appimage(appimage, destination, never_cancel).has_value());
+        CHECK(!std::filesystem::exists(destination));
+    }
+    SUBCASE("Canceled halfway through")
+    {
+        write_fake_appimage(appimage, "mkdir -p squashfs-root && echo '#!/bin/sh' > squashfs-root/AppRun && sleep 10");
+        auto const begin = std::chrono::steady_clock::now();
+        auto const res   = extract_appimage(appimage, destination, [&]() {
+            return std::chrono::steady_clock::now() - begin > std::chrono::milliseconds{200};
+        });
+        CHECK(!res.has_value());
+        CHECK(std::chrono::steady_clock::now() - begin < std::chrono::seconds{2});
+        CHECK(!std::filesystem::exists(destination));
+        CHECK(!std::filesystem::exists(folder / "squashfs-root"));
+    }
+    SUBCASE("Success")
+    {
+        write_fake_appimage(appimage, "mkdir -p squashfs-root/usr/bin && echo 'content' > squashfs-root/usr/bin/Coollab && echo 'file' && echo '#!/bin/sh' > squashfs-root/AppRun");
+        REQUIRE(extract_appimage(appimage, destination, never_cancel).has_value());
+        CHECK(std::filesystem::exists(destination / "AppRun"));
+        CHECK(std::filesystem::exists(destination / "usr/bin/Coollab"));
+        CHECK(!std::filesystem::exists(folder / "squashfs-root"));
+    }
+}
+
+/// Until Coollab writes to its log, which is the same signal of life as the one in the launch timelines
+static auto time_until_first_signal_of_life(std::filesystem::path const& executable) -> std::chrono::milliseconds
+{
+    auto const log_file     = Cool::file_logger_path("Coollab");
+    auto       error_code   = std::error_code{};
+    auto const initial_time = std::filesystem::last_write_time(log_file, error_code);
+    auto       path         = executable.string();
+    char*      argv[]       = {path.data(), nullptr}; // NOLINT(*avoid-c-arrays)
+    pid_t      pid{};
+
+    auto const begin = std::chrono::steady_clock::now();
+    bool const has_spawned = posix_spawn(&pid, path.c_str(), nullptr, nullptr, argv, environ) == 0;
+    CHECK(has_spawned);
+    if (!has_spawned)
+        return {};
+    while (std::chrono::steady_clock::now() - begin < std::chrono::seconds{30})
+    {
+        auto const time = std::filesystem::last_write_time(log_file, error_code);
+        if (!error_code && time != initial_time)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    auto const duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+    return duration;
+}
+
+TEST_CASE("Benchmark: launching an AppImage vs its extracted AppRun" * doctest::skip()) // Run with --no-skip, and COOLLAB_APPIMAGE=/path/to/Coollab.AppImage
+{
+    auto const* const appimage_to_benchmark = std::getenv("COOLLAB_APPIMAGE"); // NOLINT(*mt-unsafe)
+    if (!appimage_to_benchmark)
+    {
+        MESSAGE("Set COOLLAB_APPIMAGE to the path of a Coollab AppImage");
+        return;
+    }
+    auto const folder   = TemporaryFolder{"extract_appimage benchmark"};
+    auto const appimage = folder / "Coollab.AppImage";
+    std::filesystem::copy_file(appimage_to_benchmark, appimage);
+    std::filesystem::permissions(appimage, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+
+    auto const extraction_duration = duration_of([&]() {
+        CHECK(extract_appimage(appimage, folder / "Coollab.AppDir", never_cancel).has_value());
+    });
+    REQUIRE(std::filesystem::exists(folder / "Coollab.AppDir"));
+
+    // Interleaved, so that both modes see the same state of the caches
+    auto durations_appimage  = std::vector<std::chrono::milliseconds>{};
+    auto durations_extracted = std::vector<std::chrono::milliseconds>{};
+    for (int i = 0; i < 5; ++i)
+    {
+        durations_appimage.push_back(time_until_first_signal_of_life(appimage));
+        durations_extracted.push_back(time_until_first_signal_of_life(folder / "Coollab.AppDir" / "AppRun"));
+    }
+    auto const median = [](std::vector<std::chrono::milliseconds> durations) {
+        std::sort(durations.begin(), durations.end());
+        return durations[durations.size() / 2].count();
+    };
+
+    MESSAGE(fmt::format("Extraction: {}ms. Launch (median of 5): AppImage {}ms, extracted AppRun {}ms", extraction_duration.count(), median(durations_appimage), median(durations_extracted)));
+}
+#endif
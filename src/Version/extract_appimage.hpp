@@ -0,0 +1,10 @@
+#pragma once
+#include <filesystem>
+#include <functional>
+#include "tl/expected.hpp"
+
+/// Extracts the AppImage into `destination_folder` (which must not exist yet), so that it can be launched through the AppRun inside of it.
+/// This skips the AppImage runtime, which would otherwise mount the AppImage with FUSE and decompress it lazily on every launch (and fail on the machines that don't have FUSE).
+/// If the extraction fails or gets canceled, nothing is left at `destination_folder`.
+/// This takes a few seconds, so call it from a Task. `wants_to_cancel` is checked several times per second, and stops the extraction as soon as it returns true.
+auto extract_appimage(std::filesystem::path const& appimage, std::filesystem::path const& destination_folder, std::function<bool()> const& wants_to_cancel) -> tl::expected<void, std::string>;
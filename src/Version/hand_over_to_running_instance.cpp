@@ -0,0 +1,236 @@
+#include "hand_over_to_running_instance.hpp"
+#include <algorithm>
+#include <array>
+#include "FileDescriptor.hpp"
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) || defined(__APPLE__)
+
+static constexpr std::string_view protocol_header{"Coollab Launcher v1"}; // Change it whenever the protocol changes, so that the old instances don't misunderstand us
+
+auto running_instance_socket_path(VersionName const& version) -> std::optional<std::filesystem::path>
+{
+    // Must be short: the path of a Unix domain socket is limited to about 100 characters
+    auto file_name = fmt::format("coollab-{}-{}.sock", getuid(), version.as_string());
+    std::replace(file_name.begin(), file_name.end(), ' ', '_');
+    auto const* const runtime_dir = std::getenv("XDG_RUNTIME_DIR"); // NOLINT(*mt-unsafe)
+    return (runtime_dir && *runtime_dir ? std::filesystem::path{runtime_dir} : std::filesystem::temp_directory_path()) / file_name;
+}
+
+/// Returns false if the deadline has passed before the socket is ready
+static auto wait_for(int fd, short events, std::chrono::steady_clock::time_point deadline) -> bool
+{
+    while (true)
+    {
+        auto const remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0)
+            return false;
+        auto       fds = pollfd{.fd = fd, .events = events, .revents = 0};
+        auto const res = poll(&fds, 1, static_cast<int>(remaining.count()));
+        if (res > 0)
+            return true;
+        if (res == -1 && errno != EINTR)
+            return false;
+    }
+}
+
+auto hand_over_to_running_instance(std::filesystem::path const& socket_path, std::vector<std::string> const& command_line_args, std::chrono::milliseconds timeout) -> bool
+{
+    auto const deadline = std::chrono::steady_clock::now() + timeout;
+
+    auto request = fmt::format("{}\n", protocol_header);
+    for (auto const& arg : command_line_args)
+    {
+        if (arg.find('\n') != std::string::npos)
+            return false; // Can't be expressed in our protocol, but a new process can receive it
+        request += arg + '\n';
+    }
+    request += '\n';
+
+    auto       address = sockaddr_un{};
+    auto const path    = socket_path.string();
+    if (path.size() >= sizeof(address.sun_path))
+        return false;
+    address.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), address.sun_path); // NOLINT(*array-to-pointer-decay)
+
+    auto const socket = FileDescriptor{::socket(AF_UNIX, SOCK_STREAM, 0)};
+    if (socket.get() == -1)
+        return false;
+    // Non-blocking, so that an instance that is stuck can't block us
+    fcntl(socket.get(), F_SETFL, fcntl(socket.get(), F_GETFL) | O_NONBLOCK);
+#if defined(__APPLE__)
+    int const no_sigpipe{1};
+    setsockopt(socket.get(), SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+    static constexpr int send_flags{0};
+#else
+    static constexpr int send_flags{MSG_NOSIGNAL}; // Don't get killed if the instance closes the connection while we write
+#endif
+
+    // Fails right away when there is no instance (ENOENT), or when it has crashed and left its socket behind (ECONNREFUSED)
+    if (connect(socket.get(), reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0) // NOLINT(*reinterpret-cast)
+        return false;
+
+    size_t nb_bytes_sent{0};
+    while (nb_bytes_sent < request.size())
+    {
+        if (!wait_for(socket.get(), POLLOUT, deadline))
+            return false;
+        auto const res = send(socket.get(), request.data() + nb_bytes_sent, request.size() - nb_bytes_sent, send_flags);
+        if (res == -1)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                continue;
+            return false;
+        }
+        nb_bytes_sent += static_cast<size_t>(res);
+    }
+
+    auto answer = std::string{};
+    while (answer.find('\n') == std::string::npos)
+    {
+        if (!wait_for(socket.get(), POLLIN, deadline))
+            return false;
+        auto       buffer = std::array<char, 64>{};
+        auto const res    = recv(socket.get(), buffer.data(), buffer.size(), 0);
+        if (res == 0)
+            return false; // The instance closed the connection without answering
+        if (res == -1)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                continue;
+            return false;
+        }
+        answer.append(buffer.data(), static_cast<size_t>(res));
+    }
+    return answer.starts_with("ok\n");
+}
+
+#else
+
+auto running_instance_socket_path(VersionName const&) -> std::optional<std::filesystem::path>
+{
+    return std::nullopt;
+}
+
+auto hand_over_to_running_instance(std::filesystem::path const&, std::vector<std::string> const&, std::chrono::milliseconds) -> bool
+{
+    return false;
+}
+
+#endif
+
+#if defined(COOLLAB_LAUNCHER_TESTS) && (defined(__linux__) || defined(__APPLE__))
+#include <thread>
+#include "doctest/doctest.h"
+
+/// Plays the role of a running Coollab: accepts one connection, and answers with `answer` (or doesn't answer at all if it is std::nullopt)
+class StubInstance {
+public:
+    StubInstance(std::filesystem::path socket_path, std::optional<std::string> answer)
+        : _socket_path{std::move(socket_path)}
+    {
+        auto address       = sockaddr_un{};
+        address.sun_family = AF_UNIX;
+        auto const path    = _socket_path.string();
+        std::copy(path.begin(), path.end(), address.sun_path); // NOLINT(*array-to-pointer-decay)
+        std::filesystem::remove(_socket_path);                 // Like a real instance would, if a previous one crashed and left its socket behind
+        REQUIRE(bind(_socket.get(), reinterpret_cast<sockaddr const*>(&address), sizeof(address)) == 0); // NOLINT(*reinterpret-cast)
+        REQUIRE(listen(_socket.get(), 1) == 0);
+        _thread = std::thread{[this, answer = std::move(answer)]() {
+            int const connection = accept(_socket.get(), nullptr, nullptr);
+            if (connection == -1)
+                return;
+            auto buffer = std::array<char, 256>{};
+            while (!_request.ends_with("\n\n"))
+            {
+                auto const res = recv(connection, buffer.data(), buffer.size(), 0);
+                if (res <= 0)
+                    break;
+                _request.append(buffer.data(), static_cast<size_t>(res));
+            }
+            if (answer.has_value())
+                send(connection, answer->data(), answer->size(), 0);
+            else
+                std::this_thread::sleep_for(std::chrono::milliseconds{300}); // Stuck, longer than the timeout
+            close(connection);
+        }};
+    }
+    ~StubInstance()
+    {
+        _thread.join();
+        std::filesystem::remove(_socket_path); // Like a real instance would when it closes
+    }
+    StubInstance(StubInstance const&)                    = delete;
+    auto operator=(StubInstance const&) -> StubInstance& = delete;
+    StubInstance(StubInstance&&)                         = delete;
+    auto operator=(StubInstance&&) -> StubInstance&      = delete;
+
+    /// Only valid once the destructor has run, or once the launcher got its answer
+    auto request() const -> std::string const& { return _request; }
+
+private:
+    std::filesystem::path _socket_path;
+    FileDescriptor        _socket{socket(AF_UNIX, SOCK_STREAM, 0)};
+    std::string           _request{};
+    std::thread           _thread{}; // Must be declared last, so that it is started after everything else has been initialized
+};
+
+TEST_CASE("Handing a project over to a running instance")
+{
+    auto const socket_path = std::filesystem::temp_directory_path() / "coollab-launcher-test.sock";
+    auto const args        = std::vector<std::string>{"--open_project", "/some folder/project.coollab"};
+    auto const timeout     = std::chrono::milliseconds{100};
+    std::filesystem::remove(socket_path);
+
+    SUBCASE("The running instance opens the project")
+    {
+        auto const instance = StubInstance{socket_path, "ok\n"};
+        CHECK(hand_over_to_running_instance(socket_path, args, timeout));
+        CHECK(instance.request() == "Coollab Launcher v1\n--open_project\n/some folder/project.coollab\n\n");
+    }
+    SUBCASE("The running instance refuses")
+    {
+        auto const instance = StubInstance{socket_path, "busy\n"};
+        CHECK(!hand_over_to_running_instance(socket_path, args, timeout));
+    }
+    SUBCASE("The running instance doesn't answer in time")
+    {
+        auto const instance = StubInstance{socket_path, std::nullopt};
+        auto const begin    = std::chrono::steady_clock::now();
+        CHECK(!hand_over_to_running_instance(socket_path, args, timeout));
+        CHECK(std::chrono::steady_clock::now() - begin < std::chrono::milliseconds{250});
+    }
+    SUBCASE("No running instance")
+    {
+        CHECK(!hand_over_to_running_instance(socket_path, args, timeout));
+    }
+    SUBCASE("The running instance has crashed and left its socket behind")
+    {
+        {
+            auto const socket  = FileDescriptor{::socket(AF_UNIX, SOCK_STREAM, 0)};
+            auto       address = sockaddr_un{};
+            address.sun_family = AF_UNIX;
+            auto const path    = socket_path.string();
+            std::copy(path.begin(), path.end(), address.sun_path); // NOLINT(*array-to-pointer-decay)
+            REQUIRE(bind(socket.get(), reinterpret_cast<sockaddr const*>(&address), sizeof(address)) == 0); // NOLINT(*reinterpret-cast)
+        }
+        REQUIRE(std::filesystem::exists(socket_path));
+        CHECK(!hand_over_to_running_instance(socket_path, args, timeout));
+    }
+    SUBCASE("Arguments that can't be sent")
+    {
+        auto const instance = StubInstance{socket_path, "ok\n"};
+        CHECK(!hand_over_to_running_instance(socket_path, {"--open_project", "/weird\nname.coollab"}, timeout));
+        CHECK(hand_over_to_running_instance(socket_path, args, timeout)); // Otherwise the stub would wait forever
+    }
+
+    std::filesystem::remove(socket_path);
+}
+#endif
@@ -0,0 +1,20 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+#include "VersionName.hpp"
+
+// Protocol between the launcher and a Coollab that is already running, so that opening a project doesn't pay for the startup of a new process every time:
+//   - Each running Coollab listens on a Unix domain socket, at running_instance_socket_path(its version)
+//   - The launcher connects to it and sends "Coollab Launcher v1\n", then each command-line argument on its own line, then an empty line
+//   - The instance answers "ok\n" as soon as it has received the empty line, before doing anything with the arguments, so that the answer never comes late just because opening the project takes time.
+//     Anything else, or no answer in time, and the launcher closes the connection and spawns a new process instead
+//   - The instance only takes the arguments into account (as if it had been started with them) if it has managed to send "ok\n", i.e. if the launcher was still waiting for it. That way the project never gets opened twice
+
+/// std::nullopt on the platforms where we don't support it yet (Windows), in which case we always spawn a new process
+auto running_instance_socket_path(VersionName const&) -> std::optional<std::filesystem::path>;
+
+/// Returns false if no instance is listening on that socket (or if it has crashed and left its socket behind), or if it didn't answer in time. Never blocks longer than `timeout`
+auto hand_over_to_running_instance(std::filesystem::path const& socket_path, std::vector<std::string> const& command_line_args, std::chrono::milliseconds timeout) -> bool;
@@ -1,4 +1,5 @@
 #include "installation_path.hpp"
+#include "Cool/File/File.h"
 #include "Path.hpp"
 
 auto installation_path(VersionName const& name) -> std::filesystem::path
@@ -21,5 +22,16 @@ static auto exe_name() -> std::filesystem::path
 
 auto executable_path(VersionName const& name) -> std::filesystem::path
 {
+#if defined(__linux__)
+    if (auto const app_run = extracted_appimage_path(name) / "AppRun"; Cool::File::exists(app_run))
+        return app_run;
+#endif
     return installation_path(name) / exe_name();
-}
\ No newline at end of file
+}
+
+#if defined(__linux__)
+auto extracted_appimage_path(VersionName const& name) -> std::filesystem::path
+{
+    return installation_path(name) / "Coollab.AppDir";
+}
+#endif
\ No newline at end of file
@@ -2,4 +2,8 @@
 #include "VersionName.hpp"
 
 auto installation_path(VersionName const& name) -> std::filesystem::path;
-auto executable_path(VersionName const& name) -> std::filesystem::path;
\ No newline at end of file
+/// On Linux, the AppRun of the extracted AppImage if the version has been extracted at installation, otherwise the AppImage
+auto executable_path(VersionName const& name) -> std::filesystem::path;
+#if defined(__linux__)
+auto extracted_appimage_path(VersionName const& name) -> std::filesystem::path;
+#endif
\ No newline at end of file
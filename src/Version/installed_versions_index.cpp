@@ -0,0 +1,109 @@
+#include "installed_versions_index.hpp"
+#include <fstream>
+#include "Cool/File/File.h"
+#include "Cool/Log/Log.hpp"
+#include "Path.hpp"
+
+// The index file contains the last write time of the "Installed Versions" folder on the first line, and then one version name per line.
+// Adding or removing a version folder changes the last write time of the "Installed Versions" folder, which is how we detect that the index is outdated.
+
+static auto installed_versions_folder_write_time() -> std::optional<int64_t>
+{
+    auto       error_code = std::error_code{};
+    auto const time       = std::filesystem::last_write_time(Path::installed_versions_folder(), error_code);
+    if (error_code)
+        return std::nullopt;
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+auto read_installed_versions_index() -> std::optional<std::vector<VersionName>>
+{
+    auto const folder_write_time = installed_versions_folder_write_time();
+    if (!folder_write_time.has_value())
+        return std::nullopt;
+
+    auto file = std::ifstream{Path::installed_versions_index_file()};
+    if (!file.is_open())
+        return std::nullopt;
+
+    auto line = std::string{};
+    if (!std::getline(file, line))
+        return std::nullopt;
+    try
+    {
+        if (std::stoll(line) != *folder_write_time)
+            return std::nullopt;
+    }
+    catch (...)
+    {
+        return std::nullopt;
+    }
+
+    auto versions = std::vector<VersionName>{};
+    while (std::getline(file, line))
+    {
+        auto const version_name = VersionName::from(line);
+        if (!version_name.has_value())
+            return std::nullopt; // Corrupted index, rebuild it
+        versions.push_back(*version_name);
+    }
+    return versions;
+}
+
+void write_installed_versions_index(std::vector<VersionName> const& versions)
+{
+    auto const folder_write_time = installed_versions_folder_write_time();
+    if (!folder_write_time.has_value())
+        return; // No folder, nothing to index. We will rescan next time, which is cheap since the folder doesn't exist
+
+    auto content = std::to_string(*folder_write_time);
+    for (auto const& version : versions)
+    {
+        content += '\n';
+        content += version.as_string();
+    }
+
+    // Write to a temporary file and then rename it, so that we never leave a half-written index behind if we crash
+    auto const path     = Path::installed_versions_index_file();
+    auto const tmp_path = std::filesystem::path{path}.replace_extension(".tmp");
+    if (!Cool::File::set_content(tmp_path, content))
+        return;
+    auto error_code = std::error_code{};
+    std::filesystem::rename(tmp_path, path, error_code);
+    if (error_code)
+        Cool::Log::internal_warning("Installed versions index", error_code.message());
+}
+
+auto scan_installed_versions_folder() -> std::vector<VersionName>
+{
+    auto versions = std::vector<VersionName>{};
+    try
+    {
+        for (auto const& entry : std::filesystem::directory_iterator{Path::installed_versions_folder()})
+        {
+            try
+            {
+                if (!entry.is_directory())
+                    continue;
+                auto const version_name = VersionName::from(entry.path().filename().string()); // Use filename() and not stem(), because stem() would stop at the first dot (e.g. "folder/19.0.3" would become "19" instead of "19.0.3")
+                if (version_name.has_value())
+                    versions.push_back(*version_name);
+            }
+            catch (std::exception const& e)
+            {
+                Cool::Log::internal_error("Get all locally installed versions", e.what());
+            }
+        }
+    }
+    catch (std::exception const& e)
+    {
+        Cool::Log::internal_error("Get all locally installed versions", e.what());
+    }
+
+    // Remove duplicates in O(n log(n)) (the file system shouldn't give us any, but better safe than sorry)
+    std::sort(versions.begin(), versions.end(), [](VersionName const& a, VersionName const& b) {
+        return a.as_string() < b.as_string();
+    });
+    versions.erase(std::unique(versions.begin(), versions.end()), versions.end());
+    return versions;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include "VersionName.hpp"
+
+/// Returns the versions listed in the index file, or std::nullopt if the index is missing or outdated (i.e. the "Installed Versions" folder has been modified since the index was written)
+/// This only costs one small file read and one stat, so it is fine to call it on the main thread
+auto read_installed_versions_index() -> std::optional<std::vector<VersionName>>;
+void write_installed_versions_index(std::vector<VersionName> const&);
+
+/// Slow path, used when the index is outdated. Should be called from a Task
+auto scan_installed_versions_folder() -> std::vector<VersionName>;
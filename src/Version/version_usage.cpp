@@ -0,0 +1,113 @@
+#include "version_usage.hpp"
+#include <fstream>
+#include "Cool/File/File.h"
+#include "installation_path.hpp"
+
+static auto last_launch_time_file(VersionName const& name) -> std::filesystem::path
+{
+    return installation_path(name) / "last_launch_time.txt";
+}
+
+void record_launch_time(VersionName const& name)
+{
+    auto const seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    Cool::File::set_content(last_launch_time_file(name), std::to_string(seconds));
+}
+
+auto last_launch_time(VersionName const& name) -> std::chrono::system_clock::time_point
+{
+    auto file = std::ifstream{last_launch_time_file(name)};
+    if (file.is_open())
+    {
+        try
+        {
+            auto line = std::string{};
+            std::getline(file, line);
+            return std::chrono::system_clock::time_point{std::chrono::seconds{std::stoll(line)}};
+        }
+        catch (...) // NOLINT(*bugprone-empty-catch)
+        {
+        }
+    }
+
+    // Never launched, use the installation time instead
+    auto       error_code = std::error_code{};
+    auto const time       = std::filesystem::last_write_time(installation_path(name), error_code);
+    if (error_code)
+        return {};
+    // std::chrono::clock_cast is not available on all our compilers yet
+    return std::chrono::system_clock::now() + std::chrono::duration_cast<std::chrono::system_clock::duration>(time - std::filesystem::file_time_type::clock::now());
+}
+
+auto size_on_disk(std::filesystem::path const& folder) -> uintmax_t
+{
+    auto size       = uintmax_t{0};
+    auto error_code = std::error_code{};
+    for (auto it = std::filesystem::recursive_directory_iterator{folder, error_code}; !error_code && it != std::filesystem::recursive_directory_iterator{}; it.increment(error_code))
+    {
+        if (!it->is_regular_file(error_code))
+            continue;
+        auto const file_size = it->file_size(error_code);
+        if (!error_code)
+            size += file_size;
+    }
+    return size;
+}
+
+auto versions_to_uninstall_to_respect_quota(std::vector<VersionUsage> usages, uintmax_t quota_in_bytes) -> std::vector<VersionName>
+{
+    auto total_size = uintmax_t{0};
+    for (auto const& usage : usages)
+        total_size += usage.size_on_disk;
+
+    std::sort(usages.begin(), usages.end(), [](VersionUsage const& a, VersionUsage const& b) {
+        return a.last_launch_time < b.last_launch_time;
+    });
+
+    auto res = std::vector<VersionName>{};
+    for (auto const& usage : usages)
+    {
+        if (total_size <= quota_in_bytes)
+            break;
+        if (!usage.can_be_uninstalled)
+            continue;
+        res.push_back(usage.name);
+        total_size -= usage.size_on_disk;
+    }
+    return res;
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include "doctest/doctest.h"
+TEST_CASE("Uninstalling least recently used versions to respect the quota")
+{
+    using namespace std::chrono_literals;
+    auto const usage = [](std::string const& name, uintmax_t size, std::chrono::hours last_launch, bool can_be_uninstalled = true) {
+        return VersionUsage{*VersionName::from(name), size, std::chrono::system_clock::time_point{last_launch}, can_be_uninstalled};
+    };
+    auto const usages = std::vector<VersionUsage>{
+        usage("1.0.0", 100, 10h),
+        usage("1.1.0", 100, 30h),
+        usage("1.2.0", 100, 5h, false /*can_be_uninstalled*/),
+        usage("1.3.0", 100, 20h),
+    };
+
+    SUBCASE("Already under quota")
+    {
+        CHECK(versions_to_uninstall_to_respect_quota(usages, 400).empty());
+    }
+    SUBCASE("Uninstalls the least recently launched first")
+    {
+        auto const res = versions_to_uninstall_to_respect_quota(usages, 250);
+        REQUIRE(res.size() == 2);
+        CHECK(res[0].as_string() == "1.0.0");
+        CHECK(res[1].as_string() == "1.3.0");
+    }
+    SUBCASE("Never uninstalls protected versions, even if the quota can't be respected")
+    {
+        auto const res = versions_to_uninstall_to_respect_quota(usages, 0);
+        CHECK(res.size() == 3);
+        CHECK(std::none_of(res.begin(), res.end(), [](VersionName const& name) { return name.as_string() == "1.2.0"; }));
+    }
+}
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+#include <chrono>
+#include "VersionName.hpp"
+
+struct VersionUsage {
+    VersionName                           name;
+    uintmax_t                             size_on_disk{0};
+    std::chrono::system_clock::time_point last_launch_time{};
+    bool                                  can_be_uninstalled{true}; // False if a project needs it, or if it is the version used by default for new projects
+};
+
+void record_launch_time(VersionName const&);
+/// Returns the time when the launcher last launched this version, or the time it was installed if it has never been launched
+auto last_launch_time(VersionName const&) -> std::chrono::system_clock::time_point;
+auto size_on_disk(std::filesystem::path const& folder) -> uintmax_t;
+
+/// Least-recently-used policy: returns the versions to uninstall so that the total size gets below the quota, starting with the ones that haven't been launched for the longest time
+auto versions_to_uninstall_to_respect_quota(std::vector<VersionUsage> usages, uintmax_t quota_in_bytes) -> std::vector<VersionName>;
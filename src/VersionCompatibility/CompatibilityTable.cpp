@@ -0,0 +1,337 @@
+#include "CompatibilityTable.hpp"
+#include <limits>
+#include "Cool/Utils/overloaded.hpp"
+#include "range/v3/view.hpp"
+
+CompatibilityTable::CompatibilityTable(std::vector<CompatibilityEntry> const& entries)
+{
+    size_t     segment_start{0};
+    size_t     automatic_upgrades_start{0};
+    auto const close_segment = [&]() {
+        for (size_t i = segment_start; i < _versions.size(); ++i)
+            _versions[i].end_of_segment = _versions.size();
+        segment_start = _versions.size();
+    };
+    auto const close_automatic_upgrades = [&]() {
+        for (size_t i = automatic_upgrades_start; i < _versions.size(); ++i)
+            _versions[i].end_of_automatic_upgrades = _versions.size();
+        automatic_upgrades_start = _versions.size();
+    };
+
+    for (auto const& entry : entries | ranges::views::reverse)
+    {
+        std::visit(
+            Cool::overloaded{
+                [&](VersionName const& ver) {
+                    _versions.push_back(Version{
+                        .name                           = ver,
+                        .nb_upgrade_instructions_before = _upgrade_instructions.size(),
+                    });
+                },
+                [&](SemiIncompatibility const& semi_incompatibility) {
+                    close_automatic_upgrades();
+                    _upgrade_instructions.push_back(semi_incompatibility.upgrade_instruction);
+                },
+                [&](Incompatibility) {
+                    close_automatic_upgrades();
+                    close_segment();
+                },
+            },
+            entry
+        );
+    }
+    close_automatic_upgrades();
+    close_segment();
+
+    _indices_sorted_by_name.resize(_versions.size());
+    for (size_t i = 0; i < _versions.size(); ++i)
+        _indices_sorted_by_name[i] = i;
+    // Stable, so that if a version appears several times we find its oldest occurrence, like the old linear search did
+    std::stable_sort(_indices_sorted_by_name.begin(), _indices_sorted_by_name.end(), [&](size_t a, size_t b) {
+        return _versions[a].name.as_string() < _versions[b].name.as_string();
+    });
+}
+
+auto CompatibilityTable::index_of(VersionName const& version_name) const -> std::optional<size_t>
+{
+    auto const it = std::lower_bound(_indices_sorted_by_name.begin(), _indices_sorted_by_name.end(), version_name.as_string(), [&](size_t index, std::string const& name) {
+        return _versions[index].name.as_string() < name;
+    });
+    if (it == _indices_sorted_by_name.end() || _versions[*it].name != version_name)
+        return std::nullopt;
+    return *it;
+}
+
+auto CompatibilityTable::compatible_versions(VersionName const& version_name, std::function<bool(VersionName const&)> const& is_available) const -> std::vector<VersionNameAndUpgradeInstructions>
+{
+    auto res = std::vector<VersionNameAndUpgradeInstructions>{};
+
+    auto const index = index_of(version_name);
+    if (!index.has_value())
+        return res;
+
+    auto const first_instruction = _upgrade_instructions.begin() + static_cast<std::ptrdiff_t>(_versions[*index].nb_upgrade_instructions_before);
+    for (size_t i = *index + 1; i < _versions[*index].end_of_segment; ++i)
+    {
+        if (!is_available(_versions[i].name))
+            continue;
+        res.push_back(VersionNameAndUpgradeInstructions{
+            .name                 = _versions[i].name,
+            .upgrade_instructions = {first_instruction, _upgrade_instructions.begin() + static_cast<std::ptrdiff_t>(_versions[i].nb_upgrade_instructions_before)},
+        });
+    }
+    return res;
+}
+
+auto CompatibilityTable::version_to_upgrade_to_automatically(VersionName const& version_name, std::function<bool(VersionName const&)> const& is_available) const -> VersionToUpgradeTo
+{
+    auto const index = index_of(version_name);
+    if (!index.has_value())
+        return DontUpgrade{};
+
+    // Start from the newest, so that we usually stop at the first iteration
+    for (size_t i = _versions[*index].end_of_automatic_upgrades; i > *index + 1; --i)
+    {
+        if (is_available(_versions[i - 1].name))
+            return _versions[i - 1].name;
+    }
+    return DontUpgrade{};
+}
+
+auto CompatibilityTable::plan_upgrades(std::vector<VersionName> const& current_versions, std::function<bool(VersionName const&)> const& is_available) const -> UpgradePlan
+{
+    // Sort the queries by name, and merge them with the table's versions sorted by name, to find all their indices in one pass
+    auto queries_sorted_by_name = std::vector<size_t>(current_versions.size());
+    for (size_t i = 0; i < current_versions.size(); ++i)
+        queries_sorted_by_name[i] = i;
+    std::sort(queries_sorted_by_name.begin(), queries_sorted_by_name.end(), [&](size_t a, size_t b) {
+        return current_versions[a].as_string() < current_versions[b].as_string();
+    });
+
+    static constexpr size_t not_found = std::numeric_limits<size_t>::max();
+    auto                    index_in_table = std::vector<size_t>(current_versions.size(), not_found);
+    auto                    is_queried     = std::vector<bool>(_versions.size(), false);
+    {
+        auto table_it = _indices_sorted_by_name.begin();
+        for (size_t const query : queries_sorted_by_name)
+        {
+            auto const& name = current_versions[query].as_string();
+            while (table_it != _indices_sorted_by_name.end() && _versions[*table_it].name.as_string() < name)
+                ++table_it;
+            if (table_it == _indices_sorted_by_name.end())
+                break;
+            if (_versions[*table_it].name.as_string() != name)
+                continue;
+            index_in_table[query]  = *table_it;
+            is_queried[*table_it] = true;
+        }
+    }
+
+    // Sweep from newest to oldest. Versions that share the same end_of_automatic_upgrades are contiguous,
+    // and they all upgrade to the newest available version of their group that comes after them.
+    static constexpr size_t none = std::numeric_limits<size_t>::max();
+    auto                    target_in_table = std::vector<size_t>(_versions.size(), none);
+    size_t                  current_group_end{none};
+    size_t                  newest_available_in_group{none};
+    for (size_t i = _versions.size(); i-- > 0;)
+    {
+        if (_versions[i].end_of_automatic_upgrades != current_group_end)
+        {
+            current_group_end         = _versions[i].end_of_automatic_upgrades;
+            newest_available_in_group = none;
+        }
+        if (is_queried[i])
+            target_in_table[i] = newest_available_in_group;
+        if (newest_available_in_group == none && is_available(_versions[i].name))
+            newest_available_in_group = i;
+    }
+
+    auto res            = UpgradePlan{};
+    auto is_a_target    = std::vector<bool>(_versions.size(), false);
+    res.version_to_upgrade_to.reserve(current_versions.size());
+    for (size_t const index : index_in_table)
+    {
+        if (index == not_found || target_in_table[index] == none)
+        {
+            res.version_to_upgrade_to.emplace_back(DontUpgrade{});
+            continue;
+        }
+        res.version_to_upgrade_to.emplace_back(_versions[target_in_table[index]].name);
+        is_a_target[target_in_table[index]] = true;
+    }
+    for (size_t i = 0; i < _versions.size(); ++i)
+    {
+        if (is_a_target[i])
+            res.versions_to_upgrade_to.push_back(_versions[i].name);
+    }
+    return res;
+}
+
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include "doctest/doctest.h"
+#include "test_utils.hpp"
+
+// The implementation we had before compiling the entries into a CompatibilityTable, that we use as a reference
+static auto compatible_versions_reference(std::vector<CompatibilityEntry> const& entries, VersionName const& version_name, std::function<bool(VersionName const&)> const& is_available)
+    -> std::vector<VersionNameAndUpgradeInstructions>
+{
+    auto res                  = std::vector<VersionNameAndUpgradeInstructions>{};
+    auto upgrade_instructions = std::vector<std::string>{};
+    bool found{false};
+    for (auto const& entry : entries | ranges::views::reverse)
+    {
+        bool do_break{false};
+        std::visit(
+            Cool::overloaded{
+                [&](VersionName const& ver) {
+                    if (found && is_available(ver))
+                        res.emplace_back(VersionNameAndUpgradeInstructions{ver, upgrade_instructions});
+                    else if (ver == version_name)
+                        found = true;
+                },
+                [&](SemiIncompatibility const& semi_incompatibility) {
+                    if (found)
+                        upgrade_instructions.push_back(semi_incompatibility.upgrade_instruction);
+                },
+                [&](Incompatibility) {
+                    if (found)
+                        do_break = true;
+                },
+            },
+            entry
+        );
+        if (do_break)
+            break;
+    }
+    return res;
+}
+
+static auto synthetic_compatibility_entries(int nb_versions) -> std::vector<CompatibilityEntry>
+{
+    auto entries = std::vector<CompatibilityEntry>{};
+    for (int i = nb_versions - 1; i >= 0; --i) // From newest to oldest, like in the file
+    {
+        entries.emplace_back(*VersionName::from(fmt::format("{}.{}.{}", i / 100, (i / 10) % 10, i % 10)));
+        if (i % 37 == 0)
+            entries.emplace_back(Incompatibility{});
+        else if (i % 7 == 0)
+            entries.emplace_back(SemiIncompatibility{fmt::format("Instruction {}", i)});
+    }
+    return entries;
+}
+
+static auto is_available_for_tests(VersionName const& version) -> bool
+{
+    return version.patch() != 3; // Pretend that some versions are not available, to make sure we skip them
+}
+
+TEST_CASE("CompatibilityTable gives the same results as walking the compatibility entries")
+{
+    auto const entries = synthetic_compatibility_entries(300);
+    auto const table   = CompatibilityTable{entries};
+    for (auto const& entry : entries)
+    {
+        if (!std::holds_alternative<VersionName>(entry))
+            continue;
+        auto const& version   = std::get<VersionName>(entry);
+        auto const  expected  = compatible_versions_reference(entries, version, &is_available_for_tests);
+        auto const  result    = table.compatible_versions(version, &is_available_for_tests);
+        bool        all_equal = expected.size() == result.size();
+        for (size_t i = 0; all_equal && i < result.size(); ++i)
+            all_equal = expected[i].name == result[i].name && expected[i].upgrade_instructions == result[i].upgrade_instructions;
+        CHECK(all_equal);
+
+        auto const expected_automatic_upgrade = [&]() -> VersionToUpgradeTo {
+            auto res = VersionToUpgradeTo{DontUpgrade{}};
+            for (auto const& ver : expected)
+            {
+                if (!ver.upgrade_instructions.empty())
+                    break;
+                res = ver.name;
+            }
+            return res;
+        }();
+        CHECK(table.version_to_upgrade_to_automatically(version, &is_available_for_tests) == expected_automatic_upgrade);
+    }
+    CHECK(std::holds_alternative<DontUpgrade>(table.version_to_upgrade_to_automatically(*VersionName::from("999.0.0"), &is_available_for_tests)));
+}
+
+TEST_CASE("Planning the upgrades of all the projects at once gives the same results as querying them one by one")
+{
+    auto const entries  = synthetic_compatibility_entries(300);
+    auto const table    = CompatibilityTable{entries};
+    auto       versions = std::vector<VersionName>{};
+    for (int i = 0; i < 1000; ++i)
+        versions.push_back(*VersionName::from(fmt::format("{}.{}.{}", (i * 7919) % 310 / 100, (i * 7919) % 310 / 10 % 10, (i * 7919) % 10))); // Some of them are not in the table
+    auto const plan = table.plan_upgrades(versions, &is_available_for_tests);
+
+    REQUIRE(plan.version_to_upgrade_to.size() == versions.size());
+    auto expected_targets = std::vector<VersionName>{};
+    for (size_t i = 0; i < versions.size(); ++i)
+    {
+        auto const expected = table.version_to_upgrade_to_automatically(versions[i], &is_available_for_tests);
+        CHECK(plan.version_to_upgrade_to[i] == expected);
+        if (auto const* target = std::get_if<VersionName>(&expected))
+            expected_targets.push_back(*target);
+    }
+    std::sort(expected_targets.begin(), expected_targets.end());
+    expected_targets.erase(std::unique(expected_targets.begin(), expected_targets.end()), expected_targets.end());
+    CHECK(plan.versions_to_upgrade_to == expected_targets);
+}
+
+TEST_CASE("Benchmark: querying a long compatibility file" * doctest::skip()) // Run with --no-skip
+{
+    auto const entries = synthetic_compatibility_entries(10'000);
+    auto       queries = std::vector<VersionName>{};
+    for (auto const& entry : entries)
+    {
+        if (std::holds_alternative<VersionName>(entry))
+            queries.push_back(std::get<VersionName>(entry));
+    }
+
+    size_t     checksum_reference{0};
+    auto const duration_reference = duration_of<std::chrono::microseconds>([&]() {
+        for (auto const& query : queries)
+            checksum_reference += compatible_versions_reference(entries, query, &is_available_for_tests).size();
+    });
+    auto       table           = CompatibilityTable{};
+    auto const duration_build  = duration_of<std::chrono::microseconds>([&]() { table = CompatibilityTable{entries}; });
+    size_t     checksum_table{0};
+    auto const duration_table  = duration_of<std::chrono::microseconds>([&]() {
+        for (auto const& query : queries)
+            checksum_table += table.compatible_versions(query, &is_available_for_tests).size();
+    });
+    CHECK(checksum_reference == checksum_table);
+    MESSAGE(fmt::format("{} queries. Walking the entries: {}us. CompatibilityTable: {}us (+ {}us to build it)", queries.size(), duration_reference.count(), duration_table.count(), duration_build.count()));
+}
+
+TEST_CASE("Benchmark: planning the upgrades of 10k projects" * doctest::skip()) // Run with --no-skip
+{
+    auto const entries  = synthetic_compatibility_entries(1000);
+    auto const table    = CompatibilityTable{entries};
+    auto       projects = std::vector<VersionName>{};
+    for (int i = 0; i < 10'000; ++i)
+        projects.push_back(*VersionName::from(fmt::format("{}.{}.{}", (i * 7919) % 1000 / 100, (i * 7919) % 1000 / 10 % 10, (i * 7919) % 10)));
+
+    // Mimics VersionCompatibility, whose is_available() is a linear search through all the versions known by the VersionManager
+    auto       available_versions = std::vector<VersionName>{};
+    for (auto const& entry : entries)
+    {
+        if (std::holds_alternative<VersionName>(entry) && is_available_for_tests(std::get<VersionName>(entry)))
+            available_versions.push_back(std::get<VersionName>(entry));
+    }
+    auto const is_available = [&](VersionName const& version) {
+        return std::find(available_versions.begin(), available_versions.end(), version) != available_versions.end();
+    };
+
+    auto       targets_one_by_one  = std::vector<VersionToUpgradeTo>{};
+    auto const duration_one_by_one = duration_of<std::chrono::microseconds>([&]() {
+        for (auto const& project : projects)
+            targets_one_by_one.push_back(table.version_to_upgrade_to_automatically(project, is_available));
+    });
+    auto       plan           = UpgradePlan{};
+    auto const duration_batch = duration_of<std::chrono::microseconds>([&]() { plan = table.plan_upgrades(projects, is_available); });
+    CHECK(plan.version_to_upgrade_to == targets_one_by_one);
+    MESSAGE(fmt::format("{} projects. One by one: {}us. Batch: {}us ({} versions to upgrade to)", projects.size(), duration_one_by_one.count(), duration_batch.count(), plan.versions_to_upgrade_to.size()));
+}
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+#include <functional>
+#include "Version/VersionToUpgradeTo.hpp"
+#include "parse_compatibility_file_line.hpp"
+
+struct VersionNameAndUpgradeInstructions {
+    VersionName              name;
+    std::vector<std::string> upgrade_instructions;
+};
+
+struct UpgradePlan {
+    std::vector<VersionToUpgradeTo> version_to_upgrade_to{};  // One for each of the versions passed to plan_upgrades(), in the same order
+    std::vector<VersionName>        versions_to_upgrade_to{}; // Deduplicated, from oldest to newest
+};
+
+/// The compatibility entries, compiled so that queries are a binary search plus a slice, instead of a walk through all the entries.
+/// Incompatibilities split the versions into segments: a version can only be upgraded to the ones that come after it in the same segment.
+class CompatibilityTable {
+public:
+    CompatibilityTable() = default;
+    /// The entries must be in the same order as in the compatibility file, i.e. from newest to oldest
+    explicit CompatibilityTable(std::vector<CompatibilityEntry> const& entries);
+
+    /// `is_available` tells us if a version can be installed (i.e. is known by the VersionManager)
+    auto compatible_versions(VersionName const&, std::function<bool(VersionName const&)> const& is_available) const -> std::vector<VersionNameAndUpgradeInstructions>;
+    auto version_to_upgrade_to_automatically(VersionName const&, std::function<bool(VersionName const&)> const& is_available) const -> VersionToUpgradeTo;
+    /// Same as calling version_to_upgrade_to_automatically() for each version, but sorts them and sweeps through the table once,
+    /// and only calls `is_available` once per version of the table (at most), instead of once per version of the table per query.
+    auto plan_upgrades(std::vector<VersionName> const& current_versions, std::function<bool(VersionName const&)> const& is_available) const -> UpgradePlan;
+
+private:
+    auto index_of(VersionName const&) const -> std::optional<size_t>;
+
+private:
+    struct Version {
+        VersionName name;
+        size_t      end_of_segment{};                 // Index (excluded) of the last version this one can be upgraded to
+        size_t      end_of_automatic_upgrades{};      // Index (excluded) of the last version this one can be upgraded to without any semi-incompatibility
+        size_t      nb_upgrade_instructions_before{}; // Prefix count into _upgrade_instructions
+    };
+    std::vector<Version>     _versions{};             // From oldest to newest
+    std::vector<std::string> _upgrade_instructions{}; // From oldest to newest
+    std::vector<size_t>      _indices_sorted_by_name{};
+};
@@ -25,7 +25,7 @@ void Task_FetchCompatibilityFile::execute()
     auto line                  = std::string{};
     while (std::getline(string_stream, line))
         parse_compatibility_file_line(line, compatibility_entries);
-    version_compatibility().set_compatibility_entries(std::move(compatibility_entries));
+    version_compatibility().set_compatibility_entries(compatibility_entries);
 
     Cool::File::set_content(Path::versions_compatibility_file(), res->body);
 }
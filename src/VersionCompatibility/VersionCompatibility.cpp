@@ -1,112 +1,85 @@
 #include "VersionCompatibility.hpp"
 #include "Cool/Task/TaskManager.hpp"
-#include "Cool/Utils/overloaded.hpp"
 #include "LauncherSettings.hpp"
 #include "Path.hpp"
 #include "Task_FetchCompatibilityFile.hpp"
 #include "Version/VersionManager.hpp"
 #include "Version/VersionName.hpp"
 #include "parse_compatibility_file_line.hpp"
-#include "range/v3/view.hpp"
 
 VersionCompatibility::VersionCompatibility()
 {
     auto ifs = std::ifstream{Path::versions_compatibility_file()};
     if (ifs.is_open())
     {
-        auto line = std::string{};
+        auto compatibility_entries = std::vector<CompatibilityEntry>{};
+        auto line                  = std::string{};
         while (std::getline(ifs, line))
-            parse_compatibility_file_line(line, _compatibility_entries);
+            parse_compatibility_file_line(line, compatibility_entries);
+        _table.publish(CompatibilityTable{compatibility_entries});
     }
 
     Cool::task_manager().submit(std::make_shared<Task_FetchCompatibilityFile>()); // It's simpler to submit the task after parsing the file, it avoids concurrency if the fetch finishes before we finished parsing the file here
 }
 
-auto VersionCompatibility::compatible_versions(VersionName const& version_name) const -> std::vector<VersionNameAndUpgradeInstructions>
+static auto is_available(VersionName const& version_name) -> bool
 {
-    std::unique_lock lock{_mutex};
-
-    auto res                  = std::vector<VersionNameAndUpgradeInstructions>{};
-    auto upgrade_instructions = std::vector<std::string>{};
-
-    bool found{false};
-    for (auto const& entry : _compatibility_entries | ranges::views::reverse)
-    {
-        bool do_break{false};
-        std::visit(
-            Cool::overloaded{
-                [&](VersionName const& ver) {
-                    if (found)
-                    {
-                        if (version_manager().find(ver, true /*filter_experimental_versions*/) != nullptr)
-                            res.emplace_back(VersionNameAndUpgradeInstructions{ver, upgrade_instructions});
-                    }
-                    else
-                    {
-                        if (ver == version_name)
-                            found = true;
-                    }
-                },
-                [&](SemiIncompatibility const& semi_incompatibility) {
-                    if (found)
-                        upgrade_instructions.push_back(semi_incompatibility.upgrade_instruction);
-                },
-                [&](Incompatibility) {
-                    if (found)
-                        do_break = true;
-                },
-            },
-            entry
-        );
-
-        if (do_break)
-            break;
-    }
+    return version_manager().find(version_name, true /*filter_experimental_versions*/) != nullptr;
+}
 
-    return res;
+auto VersionCompatibility::compatible_versions(VersionName const& version_name) const -> std::vector<VersionNameAndUpgradeInstructions>
+{
+    return snapshot().compatible_versions(version_name, &is_available);
 }
 
 auto VersionCompatibility::version_to_upgrade_to_automatically(VersionName const& version_name) const -> VersionToUpgradeTo
 {
-    std::unique_lock lock{_mutex};
+    return snapshot().version_to_upgrade_to_automatically(version_name, &is_available);
+}
+
+auto VersionCompatibility::plan_upgrades(std::vector<VersionName> const& current_versions) const -> UpgradePlan
+{
+    return snapshot().plan_upgrades(current_versions, &is_available);
+}
 
-    auto res = VersionToUpgradeTo{DontUpgrade{}};
+#if defined(COOLLAB_LAUNCHER_TESTS)
+#include <thread>
+#include "doctest/doctest.h"
 
-    bool found{false};
-    for (auto const& entry : _compatibility_entries | ranges::views::reverse)
-    {
-        bool do_break{false};
-        std::visit(
-            Cool::overloaded{
-                [&](VersionName const& ver) {
-                    if (found)
-                    {
-                        if (version_manager().find(ver, true /*filter_experimental_versions*/) != nullptr)
-                        {
-                            res = ver;
-                        }
-                    }
-                    else
-                    {
-                        if (ver == version_name)
-                            found = true;
-                    }
-                },
-                [&](SemiIncompatibility const&) {
-                    if (found)
-                        do_break = true;
-                },
-                [&](Incompatibility) {
-                    if (found)
-                        do_break = true;
-                },
-            },
-            entry
-        );
+// Build with COOLLAB_LAUNCHER_TESTS_WITH_TSAN to let ThreadSanitizer check this test
+TEST_CASE("Querying the compatibility table while a new one is being published")
+{
+    auto const old_entries = std::vector<CompatibilityEntry>{*VersionName::from("1.1.0"), *VersionName::from("1.0.0")};
+    auto const new_entries = std::vector<CompatibilityEntry>{*VersionName::from("1.2.0"), *VersionName::from("1.1.0"), *VersionName::from("1.0.0")};
+    auto const always_available = [](VersionName const&) { return true; };
 
-        if (do_break)
-            break;
+    auto table     = AtomicSnapshot<CompatibilityTable>{CompatibilityTable{old_entries}};
+    auto stop      = std::atomic<bool>{false};
+    auto nb_errors = std::atomic<int>{0};
+    auto readers   = std::vector<std::thread>{};
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&]() {
+            while (!stop.load())
+            {
+                auto const& snapshot = table.get();
+                auto const  target   = snapshot.version_to_upgrade_to_automatically(*VersionName::from("1.0.0"), always_available);
+                // Whatever the table we got, it must be consistent: either the old one or the new one, never something in between
+                if (target != VersionToUpgradeTo{*VersionName::from("1.1.0")} && target != VersionToUpgradeTo{*VersionName::from("1.2.0")})
+                    nb_errors.fetch_add(1);
+                if (snapshot.compatible_versions(*VersionName::from("1.0.0"), always_available).size() != (target == VersionToUpgradeTo{*VersionName::from("1.1.0")} ? 1 : 2))
+                    nb_errors.fetch_add(1);
+            }
+        });
     }
-
-    return res;
-}
\ No newline at end of file
+    for (int i = 0; i < 100; ++i) // Like the fetch of the compatibility file, but many times to give the race more chances to happen
+    {
+        table.publish(CompatibilityTable{i % 2 == 0 ? new_entries : old_entries});
+        std::this_thread::yield();
+    }
+    stop.store(true);
+    for (auto& reader : readers)
+        reader.join();
+    CHECK(nb_errors.load() == 0);
+}
+#endif
\ No newline at end of file
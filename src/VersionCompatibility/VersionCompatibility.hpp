@@ -1,30 +1,31 @@
 #pragma once
-#include <mutex>
+#include "AtomicSnapshot.hpp"
+#include "CompatibilityTable.hpp"
+#include "UpgradeDecisionsGeneration.hpp"
 #include "Version/VersionToUpgradeTo.hpp"
 #include "parse_compatibility_file_line.hpp"
 
-struct VersionNameAndUpgradeInstructions {
-    VersionName              name;
-    std::vector<std::string> upgrade_instructions;
-};
-
 class VersionCompatibility {
 public:
     VersionCompatibility();
+    /// Lock-free. Hold on to it to make several queries against the same compatibility entries, even if new ones get fetched in the meantime
+    auto snapshot() const -> CompatibilityTable const& { return _table.get(); }
+
     auto compatible_versions(VersionName const&) const -> std::vector<VersionNameAndUpgradeInstructions>;
     auto version_to_upgrade_to_automatically(VersionName const&) const -> VersionToUpgradeTo;
+    /// Batch version of version_to_upgrade_to_automatically(), cf. CompatibilityTable::plan_upgrades()
+    auto plan_upgrades(std::vector<VersionName> const& current_versions) const -> UpgradePlan;
 
 private:
     friend class Task_FetchCompatibilityFile;
-    void set_compatibility_entries(std::vector<CompatibilityEntry>&& entries)
+    void set_compatibility_entries(std::vector<CompatibilityEntry> const& entries)
     {
-        std::unique_lock lock{_mutex};
-        _compatibility_entries = std::move(entries);
+        _table.publish(CompatibilityTable{entries});
+        upgrade_decisions_generation().bump(); // After publishing, so that anyone who sees the new generation also sees the new table
     }
 
 private:
-    std::vector<CompatibilityEntry> _compatibility_entries;
-    mutable std::mutex              _mutex;
+    AtomicSnapshot<CompatibilityTable> _table{}; // Written once per run by Task_FetchCompatibilityFile, read every frame by the UI
 };
 
 inline auto version_compatibility() -> VersionCompatibility&
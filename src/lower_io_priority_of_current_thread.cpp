@@ -0,0 +1,24 @@
+#include "lower_io_priority_of_current_thread.hpp"
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <sys/resource.h>
+#elif defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+void lower_io_priority_of_current_thread()
+{
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#elif defined(__APPLE__)
+    setiopolicy_np(IOPOL_TYPE_DISK, IOPOL_SCOPE_THREAD, IOPOL_THROTTLE);
+#elif defined(__linux__)
+    // Not exposed by glibc. Cf. linux/ioprio.h
+    static constexpr int ioprio_who_process{1}; // With an id of 0, it applies to the calling thread
+    static constexpr int ioprio_class_idle{3};
+    static constexpr int ioprio_class_shift{13};
+    syscall(SYS_ioprio_set, ioprio_who_process, 0, ioprio_class_idle << ioprio_class_shift);
+#endif
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+/// So that the OS serves the reads of Coollab (and of everything else) before the ones of this thread. For the threads that walk or poll the file system in the background
+void lower_io_priority_of_current_thread();
@@ -0,0 +1,56 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+#include "fmt/format.h"
+
+// Helpers for the tests and benchmarks at the bottom of the .cpp files. Only include this inside `#if defined(COOLLAB_LAUNCHER_TESTS)`
+
+/// An empty folder in the temp directory, for the duration of a test. Whatever a previous run might have left in it is removed first
+class TemporaryFolder {
+public:
+    explicit TemporaryFolder(std::string_view name)
+        : _path{std::filesystem::temp_directory_path() / fmt::format("Coollab Launcher test - {}", name)}
+    {
+        remove();
+        std::filesystem::create_directories(_path);
+    }
+    ~TemporaryFolder() { remove(); }
+    TemporaryFolder(TemporaryFolder const&)                    = delete;
+    auto operator=(TemporaryFolder const&) -> TemporaryFolder& = delete;
+    TemporaryFolder(TemporaryFolder&&)                         = delete;
+    auto operator=(TemporaryFolder&&) -> TemporaryFolder&      = delete;
+
+    auto path() const -> std::filesystem::path const& { return _path; }
+    auto operator/(std::filesystem::path const& relative_path) const -> std::filesystem::path { return _path / relative_path; }
+
+private:
+    void remove() const
+    {
+        auto error_code = std::error_code{};
+        std::filesystem::remove_all(_path, error_code); // Doesn't throw, so that a file that is still open (e.g. on Windows) doesn't fail the test
+    }
+
+private:
+    std::filesystem::path _path;
+};
+
+/// How long it takes to run `f`
+template<typename Duration = std::chrono::milliseconds, typename Function>
+auto duration_of(Function&& f) -> Duration
+{
+    auto const begin = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - begin);
+}
+
+/// How long it takes to run `f(iteration)` on average, for iteration in [0, nb_iterations)
+template<typename Duration = std::chrono::microseconds, typename Function>
+auto average_duration_of(int nb_iterations, Function&& f) -> Duration
+{
+    return duration_of<Duration>([&]() {
+               for (int i = 0; i < nb_iterations; ++i)
+                   f(i);
+           })
+           / nb_iterations;
+}
@@ -0,0 +1,12 @@
+#include "to_lower.hpp"
+#include <algorithm>
+#include <cctype>
+
+auto to_lower(std::string_view str) -> std::string
+{
+    auto res = std::string{str};
+    std::transform(res.begin(), res.end(), res.begin(), [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); // We need those static_casts to avoid undefined behaviour, cf. https://en.cppreference.com/w/cpp/string/byte/tolower
+    });
+    return res;
+}
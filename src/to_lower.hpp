@@ -0,0 +1,6 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+/// Only handles ASCII, which is enough to compare and search names without caring about the case
+auto to_lower(std::string_view str) -> std::string;